@@ -0,0 +1,60 @@
+#include "AIScheduler.h"
+#include <algorithm>
+using namespace std;
+
+/**********************************************************************************/
+/*                     AISCHEDULER CLASS IMPLEMENTATION                           */
+/**********************************************************************************/
+AIScheduler::AIScheduler()
+{
+}
+
+void AIScheduler::setBudget(double micros)
+{
+	m_stats.budgetMicros = max(micros, 0.0);
+	m_stats.stride = 1;
+}
+
+bool AIScheduler::enabled() const
+{
+	return m_stats.budgetMicros > 0;
+}
+
+bool AIScheduler::mayReplan(int group, double distanceToSocrates, long tick) const
+{
+	// with no budget, or close to Socrates, always re-plan
+	if (!enabled() || m_stats.stride == 1 || distanceToSocrates < FAR_DISTANCE)
+		return true;
+	// otherwise, it's this group's turn once every stride ticks
+	return (group + tick) % m_stats.stride == 0;
+}
+
+void AIScheduler::beginTick()
+{
+	m_tickStart = chrono::steady_clock::now();
+}
+
+void AIScheduler::endTick()
+{
+	chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - m_tickStart;
+	m_stats.lastTickMicros = elapsed.count();
+	if (!enabled())
+		return;
+	// went over budget: spread far-away bacteria over more ticks
+	if (m_stats.lastTickMicros > m_stats.budgetMicros)
+	{
+		m_stats.overrunTicks++;
+		m_stats.worstOverrunMicros = max(m_stats.worstOverrunMicros, m_stats.lastTickMicros - m_stats.budgetMicros);
+		m_stats.stride = min(m_stats.stride * 2, (int)MAX_STRIDE);
+	}
+	// well under budget: let them re-plan more often again
+	else if (m_stats.lastTickMicros < m_stats.budgetMicros / 2 && m_stats.stride > 1)
+	{
+		m_stats.stride--;
+	}
+}
+
+const AIBudgetStats& AIScheduler::stats() const
+{
+	return m_stats;
+}
@@ -0,0 +1,52 @@
+#ifndef AISCHEDULER_INCLUDED
+#define AISCHEDULER_INCLUDED
+
+#include <chrono>
+
+// What the AI scheduler has seen so far.
+struct AIBudgetStats
+{
+	double budgetMicros = 0;		// how long bacteria are allowed to take per tick (0 means no limit)
+	double lastTickMicros = 0;		// how long they took on the last tick
+	double worstOverrunMicros = 0;	// the furthest any tick has gone over budget
+	int overrunTicks = 0;			// how many ticks went over budget
+	int stride = 1;					// far-away bacteria re-plan once every this many ticks
+};
+
+// Bounds how much time bacteria spend deciding where to go each tick.
+// Bacteria near Socrates always re-plan, but bacteria further away are split
+// into round-robin groups, and only one group re-plans on any given tick; the
+// rest keep following their last plan.  The number of groups grows when a
+// tick goes over budget and shrinks again when there's plenty of time left.
+class AIScheduler
+{
+public:
+	AIScheduler();
+
+	// Limit bacteria to the indicated number of microseconds per tick, or
+	// turn the limit off (so every bacterium re-plans every tick) with 0.
+	void setBudget(double micros);
+
+	// Is there a budget?
+	bool enabled() const;
+
+	// Should a bacterium in the indicated group, at the indicated distance
+	// from Socrates, re-plan on the indicated tick?
+	bool mayReplan(int group, double distanceToSocrates, long tick) const;
+
+	// Call these around the bacteria's moves each tick.
+	void beginTick();
+	void endTick();
+
+	const AIBudgetStats& stats() const;
+
+private:
+	AIBudgetStats m_stats;
+	std::chrono::steady_clock::time_point m_tickStart;
+
+	// bacteria at least this far from Socrates can be put off
+	static const int FAR_DISTANCE = 72;
+	static const int MAX_STRIDE = 16;
+};
+
+#endif // AISCHEDULER_INCLUDED
@@ -6,11 +6,60 @@ using namespace std;
 /**********************************************************************************/
 /*                        ACTOR CLASS IMPLEMENTATION                              */
 /**********************************************************************************/
-Actor::Actor(StudentWorld* w, int imageID, double x, double y, int dir, int depth)
+StudentWorld* Actor::s_world = nullptr;
+
+Actor::Actor(ActorType type, int imageID, double x, double y, int dir, int depth)
 	: GraphObject(imageID, x, y, dir, depth)
 {
-	m_world = w;
+	m_type = static_cast<uint8_t>(type);
 	m_alive = true;
+	COUNT_EVENT(COUNTER_ACTORS_CREATED);
+}
+
+Actor::~Actor()
+{
+	COUNT_EVENT(COUNTER_ACTORS_DESTROYED);
+}
+
+// the qualified calls below are resolved at compile time, so the update loop never goes through the vtable
+void Actor::update()
+{
+	switch (m_type)
+	{
+		case ACTOR_DIRT: // dirt and food just sit there
+		case ACTOR_FOOD:
+			break;
+		case ACTOR_PIT:
+			static_cast<Pit*>(this)->Pit::doSomething();
+			break;
+		case ACTOR_RESTORE_HEALTH_GOODIE:
+		case ACTOR_FLAMETHROWER_GOODIE:
+		case ACTOR_EXTRA_LIFE_GOODIE:
+		case ACTOR_FUNGUS:
+			static_cast<Goodie*>(this)->Goodie::doSomething();
+			break;
+		case ACTOR_SOCRATES:
+			static_cast<Socrates*>(this)->Socrates::doSomething();
+			break;
+		case ACTOR_ECOLI:
+		case ACTOR_REGULAR_SALMONELLA:
+		case ACTOR_AGGRESSIVE_SALMONELLA:
+			static_cast<Bacterium*>(this)->Bacterium::doSomething();
+			break;
+		default:
+			doSomething();
+			break;
+	}
+}
+
+ActorType Actor::type() const
+{
+	return static_cast<ActorType>(m_type);
+}
+
+bool Actor::isBacterium() const
+{
+	return m_type == ACTOR_ECOLI || m_type == ACTOR_REGULAR_SALMONELLA || m_type == ACTOR_AGGRESSIVE_SALMONELLA;
 }
 
 bool Actor::isDead() const
@@ -18,55 +67,99 @@ bool Actor::isDead() const
 	return !m_alive;
 }
 
-void Actor::setDead()
+void Actor::setDead(EventCause cause)
+{
+	// let the world know, so it can remove this actor at the end of the tick without searching for it
+	if (m_alive)
+	{
+		m_alive = false;
+		s_world->logEvent(EVENT_DEATH, this, cause);
+		s_world->actorDied(this);
+	}
+}
+
+void Actor::setWorld(StudentWorld* w)
 {
-	m_alive = false;
+	s_world = w;
 }
 
 StudentWorld* Actor::world() const
 {
-	return m_world;
+	return s_world;
 }
 
-bool Actor::takeDamage(int damage)
+ActorHandle Actor::handle() const
+{
+	return m_handle;
+}
+
+void Actor::setHandle(ActorHandle h)
+{
+	m_handle = h;
+}
+
+bool Actor::takeDamage(int damage, EventCause /* cause */)
 {
 	return false;
 }
 
+// only dirt blocks bacteria
 bool Actor::blocksBacteriumMovement() const
 {
-	return false;
+	return m_type == ACTOR_DIRT;
 }
 
+// only food is edible
 bool Actor::isEdible() const
 {
-	return false;
+	return m_type == ACTOR_FOOD;
 }
 
+// the level isn't over until all the pits and bacteria are gone
 bool Actor::preventsLevelCompleting() const
 {
-	return false;
+	return m_type == ACTOR_PIT || isBacterium();
 }
 
 // check if actor is overlapping with a certain position with coordinates (x, y)
 bool Actor::isOverlapping(int x, int y) const
 {
+#ifdef KONTAGION_FIXED_POINT
+	// compare squared distances so no square root is needed
+	const int64_t limit = (int64_t)SPRITE_WIDTH * FIXED_ONE * SPRITE_WIDTH * FIXED_ONE;
+	return fixedDistanceSquared(fixedFromDouble(getX()), fixedFromDouble(getY()), x * FIXED_ONE, y * FIXED_ONE) <= limit;
+#else
 	if (getDistance(x, y) <= SPRITE_WIDTH)
 		return true;
 	return false;
+#endif
 }
 
 // distance formula
 double Actor::getDistance(double x, double y) const
 {
+	COUNT_EVENT(COUNTER_DISTANCE_CHECKS);
+#ifdef KONTAGION_FIXED_POINT
+	return fixedToDouble(fixedDistance(fixedFromDouble(getX()), fixedFromDouble(getY()), fixedFromDouble(x), fixedFromDouble(y)));
+#else
 	return sqrt(pow(getX() - x, 2) + pow(getY() - y, 2));
+#endif
+}
+
+// every move goes through here (moveAngle calls moveTo too), so the world can re-bucket the actor
+void Actor::moveTo(double x, double y)
+{
+	double oldX = getX();
+	double oldY = getY();
+	GraphObject::moveTo(x, y);
+	s_world->actorMoved(this, oldX, oldY);
 }
 
 /**********************************************************************************/
 /*                        DIRT CLASS IMPLEMENTATION                               */
 /**********************************************************************************/
-Dirt::Dirt(StudentWorld* w, double x, double y)
-	: Actor(w, IID_DIRT, x, y, 0, 1)
+Dirt::Dirt(double x, double y)
+	: Actor(ACTOR_DIRT, IID_DIRT, x, y, 0, 1)
 {
 }
 
@@ -74,27 +167,23 @@ void Dirt::doSomething()
 {
 }
 
-bool Dirt::blocksBacteriumMovement() const
-{
-	return true;
-}
-
 // if dirt gets hit by a projectile once, it'll die
 // we're not going to count that as being able to take damage
 // doing so allows us to distinguish between dirt and agents, particularly bacterium, which is useful in StudentWorld.cpp
-bool Dirt::takeDamage(int damage)
+bool Dirt::takeDamage(int damage, EventCause cause)
 {
 	m_hp -= damage;
+	world()->logEvent(EVENT_DAMAGE, this, cause, EVENT_NO_ACTOR, damage);
 	if (m_hp <= 0)
-		setDead();
+		setDead(cause);
 	return false;
 }
 
 /**********************************************************************************/
 /*                        FOOD CLASS IMPLEMENTATION                               */
 /**********************************************************************************/
-Food::Food(StudentWorld* w, double x, double y)
-	: Actor(w, IID_FOOD, x, y, 90, 1)
+Food::Food(double x, double y)
+	: Actor(ACTOR_FOOD, IID_FOOD, x, y, 90, 1)
 {
 }
 
@@ -102,20 +191,15 @@ void Food::doSomething()
 {
 }
 
-bool Food::isEdible() const
-{
-	return true;
-}
-
 /**********************************************************************************/
 /*                        PIT CLASS IMPLEMENTATION                                */
 /**********************************************************************************/
-Pit::Pit(StudentWorld* w, double x, double y)
-	: Actor(w, IID_PIT, x, y, 0, 1)
+Pit::Pit(double x, double y, int nRegularSalmonella, int nAggressiveSalmonella, int nEColi)
+	: Actor(ACTOR_PIT, IID_PIT, x, y, 0, 1)
 {
-	m_nRegularSalmonella = 5;
-	m_nAggressiveSalmonella = 3;
-	m_nEColi = 2;
+	m_nRegularSalmonella = nRegularSalmonella;
+	m_nAggressiveSalmonella = nAggressiveSalmonella;
+	m_nEColi = nEColi;
 }
 
 void Pit::doSomething()
@@ -123,121 +207,99 @@ void Pit::doSomething()
 	// if there are no more bacterium coming out of the pit, Pit should die
 	if (m_nRegularSalmonella == 0 && m_nAggressiveSalmonella == 0 && m_nEColi == 0)
 	{
-		setDead();
+		setDead(CAUSE_EMPTIED);
 		return;
 	}
-	// There's a 1 in 50 chance per tick that the Pit releases a bacterium
-	// There's a 50% chance that that bacterium is a regular salmonella,
-	// a 30% chance that that bacterium is an aggressive salmonella, and
-	// a 20% chance that that bacterium is an E. Coli.
-	int random = randInt(1, 500);
-	if (random >= 1 && random <= 5 && m_nRegularSalmonella != 0)
+	// Out of the kinds of bacterium the Pit still has, choose one with these weights:
+	// 5 for a regular salmonella, 3 for an aggressive salmonella, and 2 for an E. Coli.
+	// (These are the same odds as rolling 1-500 every tick and releasing a regular salmonella
+	// on 1-5, an aggressive salmonella on 6-8, and an E. Coli on 9-10, given that something was released.)
+	int regular = (m_nRegularSalmonella != 0 ? 5 : 0);
+	int aggressive = (m_nAggressiveSalmonella != 0 ? 3 : 0);
+	int eColi = (m_nEColi != 0 ? 2 : 0);
+	int random = randInt(1, regular + aggressive + eColi);
+	if (random <= regular)
 	{
-		world()->addActor(new RegularSalmonella(world(), getX(), getY()));
+		world()->addActor(new RegularSalmonella(getX(), getY()), CAUSE_PIT);
 		m_nRegularSalmonella--;
-		world()->playSound(SOUND_BACTERIUM_BORN);
 	}
-	else if (random >= 6 && random <= 8 && m_nAggressiveSalmonella != 0)
+	else if (random <= regular + aggressive)
 	{
-		world()->addActor(new AggressiveSalmonella(world(), getX(), getY()));
+		world()->addActor(new AggressiveSalmonella(getX(), getY()), CAUSE_PIT);
 		m_nAggressiveSalmonella--;
-		world()->playSound(SOUND_BACTERIUM_BORN);
 	}
-	else if (random >= 9 && random <= 10 && m_nEColi != 0)
+	else
 	{
-		world()->addActor(new EColi(world(), getX(), getY()));
+		world()->addActor(new EColi(getX(), getY()), CAUSE_PIT);
 		m_nEColi--;
-		world()->playSound(SOUND_BACTERIUM_BORN);
 	}
-}
-
-bool Pit::preventsLevelCompleting() const
-{
-	return true;
-}
-
-/**********************************************************************************/
-/*                    PROJECTILE CLASS IMPLEMENTATION                             */
-/**********************************************************************************/
-Projectile::Projectile(StudentWorld* w, int imageID, double x, double y, int dir, int dist, int power)
-	: Actor(w, imageID, x, y, dir, 1)
-{
-	m_travelDistance = dist;
-	m_damagePower = power;
-}
-
-void Projectile::doSomething()
-{
-	if (isDead())
-		return;
-	// try to damage an actor; if it works, set itself (projectile) to dead
-	if (world()->damageOneActor(this, m_damagePower))
-		setDead();
-	// otherwise, keep moving forward
-	else
+	world()->playSound(SOUND_BACTERIUM_BORN);
+	// sleep until the next bacterium is due
+	world()->scheduleActor(this, ticksUntilNextRelease());
+}
+
+int Pit::ticksUntilNextRelease() const
+{
+	// once the pit is empty, wake up next tick so it can die
+	int total = (m_nRegularSalmonella != 0 ? 5 : 0) + (m_nAggressiveSalmonella != 0 ? 3 : 0) + (m_nEColi != 0 ? 2 : 0);
+	if (total == 0)
+		return 1;
+	// each tick, something is released with probability total/500, so the wait until the
+	// next release is geometrically distributed; sample it directly instead of rolling every tick
+#ifdef KONTAGION_FIXED_POINT
+	// the same wait without logarithms: the most ticks k with (1 - p)^k >= u, found by
+	// multiplying out (1 - p)^k in 32.32 fixed point until it drops below u
+	const uint64_t ONE = (uint64_t)1 << 32;
+	uint64_t u = randInt(1, 1000000) * ONE / 1000000;
+	uint64_t stay = ONE;
+	int k = 0;
+	for (;;)
 	{
-		moveAngle(getDirection(), SPRITE_WIDTH);
-		m_travelDistance -= SPRITE_WIDTH;
+		stay = stay * (500 - total) / 500;
+		if (stay < u)
+			return 1 + k;
+		k++;
 	}
-	// if projectile has travelled its limit, set itself to dead
-	if (m_travelDistance <= 0)
-		setDead();
+#else
+	double p = total / 500.0;
+	double u = randInt(1, 1000000) / 1000000.0;
+	return 1 + (int)(log(u) / log(1 - p));
+#endif
 }
 
 /**********************************************************************************/
-/*                         SPRAY CLASS IMPLEMENTATION                             */
+/*                         GOODIE CLASS IMPLEMENTATION                            */
 /**********************************************************************************/
-Spray::Spray(StudentWorld* w, double x, double y, int dir)
-	: Projectile(w, IID_SPRAY, x, y, dir, 112, 2)
+Goodie::Goodie(ActorType type, int imageID, double x, double y)
+	: Actor(type, imageID, x, y, 0, 1)
 {
+	m_lifetime = max(randInt(0, 300 - 10 * world()->getLevel() - 1), 50);
 }
 
-void Spray::beImplemented() const
-{
-	return;
-}
-
-/**********************************************************************************/
-/*                         FLAME CLASS IMPLEMENTATION                             */
-/**********************************************************************************/
-Flame::Flame(StudentWorld* w, double x, double y, int dir)
-	: Projectile(w, IID_FLAME, x, y, dir, 32, 5)
+void Goodie::doSomething()
 {
+	if (isDead())
+		return;
+	// lifetime has run out, so too much time has passed; set Goodie to dead
+	setDead(CAUSE_EXPIRED);
 }
 
-void Flame::beImplemented() const
+void Goodie::pickUp(Socrates* socrates)
 {
-	return;
+	if (isDead())
+		return;
+	// all goodies play the same sound, but fungus plays no sound at all
+	playSound();
+	// each Goodie subclass performs a special action, usually affecting the player
+	int scoreBefore = world()->getScore();
+	performSpecialAction(socrates);
+	world()->logEvent(EVENT_GOODIE_PICKUP, this, CAUSE_NONE, ACTOR_SOCRATES, world()->getScore() - scoreBefore);
+	setDead(CAUSE_PICKED_UP);
 }
 
-/**********************************************************************************/
-/*                         GOODIE CLASS IMPLEMENTATION                            */
-/**********************************************************************************/
-Goodie::Goodie(StudentWorld* w, int imageID, double x, double y)
-	: Actor(w, imageID, x, y, 0, 1)
+int Goodie::lifetime() const
 {
-	m_lifetime = max(randInt(0, 300 - 10 * w->getLevel() - 1), 50);
-}
-
-void Goodie::doSomething()
-{
-	if (isDead())
-		return;
-	// check if Socrates picked up the Goodie
-	Socrates* socrates = world()->getOverlappingSocrates(this);
-	if (socrates != nullptr)
-	{
-		// all goodies play the same sound, but fungus plays no sound at all
-		playSound();
-		// each Goodie subclass performs a special action, usually affecting the player
-		performSpecialAction(socrates);
-		setDead();
-	}
-	// after every tick, subtract lifetime by one
-	m_lifetime--;
-	// if lifetime reaches 0, too much time has passed, and set Goodie to dead
-	if (m_lifetime <= 0)
-		setDead();
+	return m_lifetime;
 }
 
 // this is for most Goodies (except fungus)
@@ -249,8 +311,8 @@ void Goodie::playSound()
 /**********************************************************************************/
 /*                   RESTOREHEALTHGOODIE CLASS IMPLEMENTATION                     */
 /**********************************************************************************/
-RestoreHealthGoodie::RestoreHealthGoodie(StudentWorld* w, double x, double y)
-	: Goodie(w, IID_RESTORE_HEALTH_GOODIE, x, y)
+RestoreHealthGoodie::RestoreHealthGoodie(double x, double y)
+	: Goodie(ACTOR_RESTORE_HEALTH_GOODIE, IID_RESTORE_HEALTH_GOODIE, x, y)
 {
 }
 
@@ -263,8 +325,8 @@ void RestoreHealthGoodie::performSpecialAction(Socrates* s)
 /**********************************************************************************/
 /*                    FLAMETHROWERGOODIE CLASS IMPLEMENTATION                     */
 /**********************************************************************************/
-FlamethrowerGoodie::FlamethrowerGoodie(StudentWorld* w, double x, double y)
-	: Goodie(w, IID_FLAME_THROWER_GOODIE, x, y)
+FlamethrowerGoodie::FlamethrowerGoodie(double x, double y)
+	: Goodie(ACTOR_FLAMETHROWER_GOODIE, IID_FLAME_THROWER_GOODIE, x, y)
 {
 }
 
@@ -277,8 +339,8 @@ void FlamethrowerGoodie::performSpecialAction(Socrates* s)
 /**********************************************************************************/
 /*                      EXTRALIFEGOODIE CLASS IMPLEMENTATION                      */
 /**********************************************************************************/
-ExtraLifeGoodie::ExtraLifeGoodie(StudentWorld* w, double x, double y)
-	: Goodie(w, IID_EXTRA_LIFE_GOODIE, x, y)
+ExtraLifeGoodie::ExtraLifeGoodie(double x, double y)
+	: Goodie(ACTOR_EXTRA_LIFE_GOODIE, IID_EXTRA_LIFE_GOODIE, x, y)
 {
 }
 
@@ -291,15 +353,15 @@ void ExtraLifeGoodie::performSpecialAction(Socrates* s)
 /**********************************************************************************/
 /*                         FUNGUS CLASS IMPLEMENTATION                            */
 /**********************************************************************************/
-Fungus::Fungus(StudentWorld* w, double x, double y)
-	: Goodie(w, IID_FUNGUS, x, y)
+Fungus::Fungus(double x, double y)
+	: Goodie(ACTOR_FUNGUS, IID_FUNGUS, x, y)
 {
 }
 
 void Fungus::performSpecialAction(Socrates* s)
 {
 	world()->increaseScore(-50);
-	s->takeDamage(20);
+	s->takeDamage(20, CAUSE_FUNGUS);
 }
 
 // overrides Goodie::playSound(), which is virtual
@@ -311,20 +373,24 @@ void Fungus::playSound()
 /**********************************************************************************/
 /*                          AGENT CLASS IMPLEMENTATION                            */
 /**********************************************************************************/
-Agent::Agent(StudentWorld* w, int imageID, double x, double y, int dir, int hitPoints)
-	: Actor(w, imageID, x, y, dir, 0)
+Agent::Agent(ActorType type, int imageID, double x, double y, int dir, int hitPoints)
+	: Actor(type, imageID, x, y, dir, 0)
 {
-	m_hp = m_maxHP = hitPoints;
+	m_hp = m_maxHP = static_cast<int16_t>(hitPoints);
 }
 
-bool Agent::takeDamage(int damage)
+bool Agent::takeDamage(int damage, EventCause cause)
 {
-	m_hp -= damage;
+	// a stress test can make Socrates immune, so he never runs out of lives
+	if (type() == ACTOR_SOCRATES && world()->isSocratesInvulnerable())
+		return true;
+	m_hp = static_cast<int16_t>(m_hp - damage);
+	world()->logEvent(EVENT_DAMAGE, this, cause, EVENT_NO_ACTOR, damage);
 	// Socrates, Salmonella, and E. Coli each has a different sound for getting hurt
 	playHurt();
 	if (m_hp <= 0)
 	{
-		setDead();
+		setDead(cause);
 		// Socrates, Salmonella, and E. Coli each has a different sound for dying
 		playDead();
 	}
@@ -342,11 +408,33 @@ void Agent::restoreHealth()
 	m_hp = m_maxHP;
 }
 
+// Socrates, Salmonella, and E. Coli each has a different sound for getting hurt
+void Agent::playHurt() const
+{
+	if (type() == ACTOR_SOCRATES)
+		world()->playSound(SOUND_PLAYER_HURT);
+	else if (type() == ACTOR_ECOLI)
+		world()->playSound(SOUND_ECOLI_HURT);
+	else
+		world()->playSound(SOUND_SALMONELLA_HURT);
+}
+
+// Socrates, Salmonella, and E. Coli each has a different sound for dying
+void Agent::playDead() const
+{
+	if (type() == ACTOR_SOCRATES)
+		world()->playSound(SOUND_PLAYER_DIE);
+	else if (type() == ACTOR_ECOLI)
+		world()->playSound(SOUND_ECOLI_DIE);
+	else
+		world()->playSound(SOUND_SALMONELLA_DIE);
+}
+
 /**********************************************************************************/
 /*                         SOCRATES CLASS IMPLEMENTATION                          */
 /**********************************************************************************/
-Socrates::Socrates(StudentWorld* w, double x, double y)
-	: Agent(w, IID_PLAYER, x, y, 0, 100)
+Socrates::Socrates(double x, double y)
+	: Agent(ACTOR_SOCRATES, IID_PLAYER, x, y, 0, 100)
 {
 	m_nFlames = 5;
 	m_nSprays = 20;
@@ -382,7 +470,7 @@ void Socrates::doSomething()
 				{
 					double dx, dy;
 					getPositionInThisDirection(getDirection(), SPRITE_WIDTH, dx, dy);
-					world()->addActor(new Spray(world(), dx, dy, getDirection()));
+					world()->addSpray(dx, dy, getDirection());
 					world()->playSound(SOUND_PLAYER_SPRAY);
 					m_nSprays--;
 				}
@@ -398,7 +486,7 @@ void Socrates::doSomething()
 					{
 						double dx, dy;
 						getPositionInThisDirection(angle, SPRITE_WIDTH, dx, dy);
-						world()->addActor(new Flame(world(), dx, dy, angle));
+						world()->addFlame(dx, dy, angle);
 					}
 				}
 				break;
@@ -426,10 +514,17 @@ void Socrates::moveAroundCircle(int angle)
 	// make sure angle is between 0 and 360
 	while (posAngle >= 360)
 		posAngle -= 360;
+	// the dish's center is (radius, radius)
+	int radius = world()->dishRadius();
+#ifdef KONTAGION_FIXED_POINT
+	double x = fixedToDouble(radius * fixedCos(posAngle));
+	double y = fixedToDouble(radius * fixedSin(posAngle));
+#else
 	const double pi = 4 * atan(1);
-	double x = VIEW_RADIUS * cos(posAngle * 1.0 / 360 * 2 * pi);
-	double y = VIEW_RADIUS * sin(posAngle * 1.0 / 360 * 2 * pi);
-	moveTo(VIEW_RADIUS + x, VIEW_RADIUS + y);
+	double x = radius * cos(posAngle * 1.0 / 360 * 2 * pi);
+	double y = radius * sin(posAngle * 1.0 / 360 * 2 * pi);
+#endif
+	moveTo(radius + x, radius + y);
 }
 
 void Socrates::addFlames()
@@ -447,30 +542,15 @@ int Socrates::numSprays() const
 	return m_nSprays;
 }
 
-void Socrates::playHurt() const
-{
-	world()->playSound(SOUND_PLAYER_HURT);
-}
-
-void Socrates::playDead() const
-{
-	world()->playSound(SOUND_PLAYER_DIE);
-}
-
 /**********************************************************************************/
 /*                         BACTERIUM CLASS IMPLEMENTATION                         */
 /**********************************************************************************/
-Bacterium::Bacterium(StudentWorld* w, int imageID, double x, double y, int hitPoints)
-	: Agent(w, imageID, x, y, 90, hitPoints)
+Bacterium::Bacterium(ActorType type, int imageID, double x, double y, int hitPoints)
+	: Agent(type, imageID, x, y, 90, hitPoints)
 {
 	m_foodEaten = 0;
 }
 
-bool Bacterium::preventsLevelCompleting() const
-{
-	return true;
-}
-
 void Bacterium::doSomething()
 {
 	if (isDead())
@@ -481,22 +561,25 @@ void Bacterium::doSomething()
 	Socrates* socrates = world()->getOverlappingSocrates(this);
 	// if so, make Socrates take the damage (severity of damage depends on the type of bacterium)
 	if (socrates != nullptr)
-		socrates->takeDamage(getDamage());
+		socrates->takeDamage(getDamage(), CAUSE_BACTERIUM);
 	// otherwise, check if food count is high enough to regenerate
 	else if (foodEaten() == 3)
 	{
+		// the new bacterium is nudged toward the center of the dish
+		int center = world()->dishRadius();
 		double newX = getX();
-		if (newX < VIEW_WIDTH / 2)
+		if (newX < center)
 			newX += SPRITE_WIDTH / 2;
-		else if (newX > VIEW_WIDTH / 2)
+		else if (newX > center)
 			newX -= SPRITE_WIDTH / 2;
 		double newY = getY();
-		if (newY < VIEW_HEIGHT / 2)
+		if (newY < center)
 			newY += SPRITE_WIDTH / 2;
-		else if (newX > VIEW_HEIGHT / 2)
+		else if (newX > center)
 			newY -= SPRITE_WIDTH / 2;
 		addBacterium(newX, newY);
 		divide();
+		world()->logEvent(EVENT_DIVISION, this, CAUSE_NONE);
 	}
 	// otherwise, check if bacterium overlaps with food
 	else
@@ -506,7 +589,8 @@ void Bacterium::doSomething()
 		if (edible != nullptr)
 		{
 			eatFood();
-			edible->setDead();
+			world()->logEvent(EVENT_FOOD_EATEN, this, CAUSE_NONE, edible->type());
+			edible->setDead(CAUSE_EATEN);
 		}
 	}
 	// if we chased Socrates already, return and don't do the next step
@@ -531,27 +615,75 @@ void Bacterium::divide()
 	m_foodEaten = 0;
 }
 
-/**********************************************************************************/
-/*                           ECOLI CLASS IMPLEMENTATION                           */
-/**********************************************************************************/
-EColi::EColi(StudentWorld* w, double x, double y)
-	: Bacterium(w, IID_ECOLI, x, y, 5)
+// E. Coli do 4 points of damage to Socrates; both kinds of salmonella do 2
+int Bacterium::getDamage() const
+{
+	if (type() == ACTOR_ECOLI)
+		return 4;
+	return 2;
+}
+
+// a bacterium divides into another bacterium of the same type
+void Bacterium::addBacterium(double newX, double newY)
+{
+	switch (type())
+	{
+		case ACTOR_ECOLI:
+			world()->addActor(new EColi(newX, newY), CAUSE_DIVISION);
+			break;
+		case ACTOR_REGULAR_SALMONELLA:
+			world()->addActor(new RegularSalmonella(newX, newY), CAUSE_DIVISION);
+			break;
+		default:
+			world()->addActor(new AggressiveSalmonella(newX, newY), CAUSE_DIVISION);
+			break;
+	}
+}
+
+void Bacterium::doMore()
 {
+	if (type() == ACTOR_ECOLI)
+		static_cast<EColi*>(this)->doMore();
+	else
+		static_cast<Salmonella*>(this)->doMore();
 }
 
-int EColi::getDamage() const
+// only aggressive salmonella go after Socrates before doing anything else
+bool Bacterium::aggressiveSalmonellaOnly()
 {
-	return 4;
+	if (type() == ACTOR_AGGRESSIVE_SALMONELLA)
+		return static_cast<AggressiveSalmonella*>(this)->aggressiveSalmonellaOnly();
+	return false;
 }
 
-void EColi::addBacterium(double newX, double newY)
+/**********************************************************************************/
+/*                           ECOLI CLASS IMPLEMENTATION                           */
+/**********************************************************************************/
+EColi::EColi(double x, double y)
+	: Bacterium(ACTOR_ECOLI, IID_ECOLI, x, y, 5)
 {
-	world()->addActor(new EColi(world(), newX, newY));
+	m_plannedAngle = 0;
+	m_hasPlan = false;
 }
 
 void EColi::doMore()
 {
+	// if it isn't this E. Coli's turn to re-plan, keep heading the way it last decided to (until something is in the way)
+	if (!world()->mayReplan(this))
+	{
+		if (m_hasPlan)
+		{
+			double dx, dy;
+			getPositionInThisDirection(m_plannedAngle, 2, dx, dy);
+			if (!world()->isBacteriumMovementBlockedAt(this, dx, dy))
+				moveTo(dx, dy);
+			else
+				m_hasPlan = false;
+		}
+		return;
+	}
 	// aggressively hunt down Socrates
+	m_hasPlan = false;
 	int angle;
 	bool socratesNearby = world()->getAngleToNearbySocrates(this, 256, angle);
 	if (socratesNearby)
@@ -565,6 +697,8 @@ void EColi::doMore()
 			if (!world()->isBacteriumMovementBlockedAt(this, dx, dy))
 			{
 				moveTo(dx, dy);
+				m_plannedAngle = static_cast<int16_t>(angle);
+				m_hasPlan = true;
 				return;
 			}
 			// otherwise, adjust angle by 10 degrees
@@ -573,26 +707,11 @@ void EColi::doMore()
 	}
 }
 
-void EColi::playHurt() const
-{
-	world()->playSound(SOUND_ECOLI_HURT);
-}
-
-void EColi::playDead() const
-{
-	world()->playSound(SOUND_ECOLI_DIE);
-}
-
-bool EColi::aggressiveSalmonellaOnly()
-{
-	return false;
-}
-
 /**********************************************************************************/
 /*                        SALMONELLA CLASS IMPLEMENTATION                         */
 /**********************************************************************************/
-Salmonella::Salmonella(StudentWorld* w, double x, double y, int hitPoints)
-	: Bacterium(w, IID_SALMONELLA, x, y, hitPoints)
+Salmonella::Salmonella(ActorType type, double x, double y, int hitPoints)
+	: Bacterium(type, IID_SALMONELLA, x, y, hitPoints)
 {
 	m_movementPlan = 10;
 }
@@ -611,7 +730,8 @@ void Salmonella::doMore()
 	{
 		int angle;
 		// if there is food within 128 pixels of the salmonella, try to move toward the food
-		if (world()->getAngleToNearestNearbyEdible(this, 128, angle))
+		// (if it isn't this salmonella's turn to re-plan, don't look; just keep going, and look again next tick)
+		if (world()->mayReplan(this) && world()->getAngleToNearestNearbyEdible(this, 128, angle))
 		{
 			setDirection(angle);
 			Salmonella::attemptMove(angle);
@@ -641,55 +761,20 @@ void Salmonella::attemptMove(int angle)
 	moveTo(dx,dy);
 }
 
-void Salmonella::playHurt() const
-{
-	world()->playSound(SOUND_SALMONELLA_HURT);
-}
-
-void Salmonella::playDead() const
-{
-	world()->playSound(SOUND_SALMONELLA_DIE);
-}
-
 /**********************************************************************************/
 /*                 REGULARSALMONELLA CLASS IMPLEMENTATION                         */
 /**********************************************************************************/
-RegularSalmonella::RegularSalmonella(StudentWorld* w, double x, double y)
-	: Salmonella(w, x, y, 4)
-{
-}
-
-int RegularSalmonella::getDamage() const
-{
-	return 2;
-}
-
-void RegularSalmonella::addBacterium(double newX, double newY)
-{
-	world()->addActor(new RegularSalmonella(world(), newX, newY));
-}
-
-bool RegularSalmonella::aggressiveSalmonellaOnly()
+RegularSalmonella::RegularSalmonella(double x, double y)
+	: Salmonella(ACTOR_REGULAR_SALMONELLA, x, y, 4)
 {
-	return false;
 }
 
 /**********************************************************************************/
 /*                 AGGRESSIVESALMONELLA CLASS IMPLEMENTATION                      */
 /**********************************************************************************/
-AggressiveSalmonella::AggressiveSalmonella(StudentWorld* w, double x, double y)
-	: Salmonella(w, x, y, 10)
-{
-}
-
-int AggressiveSalmonella::getDamage() const
-{
-	return 2;
-}
-
-void AggressiveSalmonella::addBacterium(double newX, double newY)
+AggressiveSalmonella::AggressiveSalmonella(double x, double y)
+	: Salmonella(ACTOR_AGGRESSIVE_SALMONELLA, x, y, 10)
 {
-	world()->addActor(new AggressiveSalmonella(world(), newX, newY));
 }
 
 bool AggressiveSalmonella::aggressiveSalmonellaOnly()
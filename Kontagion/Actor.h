@@ -2,39 +2,82 @@
 #define ACTOR_INCLUDED
 
 #include "GraphObject.h"
+#include "ActorSlotMap.h"
+#include "EventLog.h"
+#include "EngineCounters.h"
+#include "ActorPool.h"
 
 class StudentWorld;
 class Socrates;
 
+// Every concrete kind of actor.  Each actor records its type so that the
+// per-tick update loop and the hot query helpers can switch on it instead of
+// going through a virtual call.
+enum ActorType
+{
+	ACTOR_DIRT,
+	ACTOR_FOOD,
+	ACTOR_PIT,
+	ACTOR_RESTORE_HEALTH_GOODIE,
+	ACTOR_FLAMETHROWER_GOODIE,
+	ACTOR_EXTRA_LIFE_GOODIE,
+	ACTOR_FUNGUS,
+	ACTOR_SOCRATES,
+	ACTOR_ECOLI,
+	ACTOR_REGULAR_SALMONELLA,
+	ACTOR_AGGRESSIVE_SALMONELLA,
+	NUM_ACTOR_TYPES
+};
+
 class Actor : public GraphObject
 {
 public:
-	Actor(StudentWorld* w, int imageID, double x, double y, int dir, int depth);
+	Actor(ActorType type, int imageID, double x, double y, int dir, int depth);
+	virtual ~Actor();
 
 	// Action to perform for each tick.
 	virtual void doSomething() = 0;
 
+	// Perform this tick's action, calling the right doSomething directly
+	// based on this actor's type rather than through the vtable.
+	void update();
+
+	// What kind of actor is this?
+	ActorType type() const;
+
+	// Is this actor one of the bacteria?
+	bool isBacterium() const;
+
 	// Is this actor dead?
 	bool isDead() const;
 
-	// Mark this actor as dead.
-	void setDead();
+	// Mark this actor as dead, for the indicated reason.
+	void setDead(EventCause cause);
 
 	// Get this actor's world
 	StudentWorld* world() const;
 
+	// Set the world every actor belongs to.  There's only ever one world, so
+	// it's kept once for all actors rather than in each one; StudentWorld
+	// sets it when it's created and clears it when it's destroyed.
+	static void setWorld(StudentWorld* w);
+
+	// Get the handle the world gave this actor when it was added.
+	ActorHandle handle() const;
+	void setHandle(ActorHandle h);
+
 	// If this actor can suffer damage, make it do so and return true;
-	// otherwise, return false.
-	virtual bool takeDamage(int damage);
+	// otherwise, return false.  cause is what did the damage.
+	virtual bool takeDamage(int damage, EventCause cause);
 
 	// Does this object block bacterium movement?
-	virtual bool blocksBacteriumMovement() const;
+	bool blocksBacteriumMovement() const;
 
 	// Is this object edible?
-	virtual bool isEdible() const;
+	bool isEdible() const;
 
 	// Does the existence of this object prevent a level from being completed?
-	virtual bool preventsLevelCompleting() const;
+	bool preventsLevelCompleting() const;
 
 	// Does this actor overlap with a certain position?
 	bool isOverlapping(int x, int y) const;
@@ -42,42 +85,51 @@ public:
 	// How far is this actor from another position?
 	double getDistance(double x, double y) const;
 
+	// Move this actor to (x, y), keeping the world's spatial index up to date.
+	virtual void moveTo(double x, double y);
+
 private:
-	StudentWorld* m_world;
+	static StudentWorld* s_world;
+	ActorHandle m_handle;
+	uint8_t m_type;		// an ActorType, stored narrowly to keep actors small
 	bool m_alive;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class Dirt : public Actor
+class Dirt : public Actor, public Pooled<Dirt>
 {
 public:
-	Dirt(StudentWorld* w, double x, double y);
+	Dirt(double x, double y);
 	virtual void doSomething();
-	virtual bool takeDamage(int damage);
-	virtual bool blocksBacteriumMovement() const;
+	virtual bool takeDamage(int damage, EventCause cause);
 private:
 	int m_hp = 1;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class Food : public Actor
+class Food : public Actor, public Pooled<Food>
 {
 public:
-	Food(StudentWorld* w, double x, double y);
+	Food(double x, double y);
 	virtual void doSomething();
-	virtual bool isEdible() const;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class Pit : public Actor
+class Pit : public Actor, public Pooled<Pit>
 {
 public:
-	Pit(StudentWorld* w, double x, double y);
+	// A pit starts out holding the indicated numbers of each kind of bacterium.
+	Pit(double x, double y, int nRegularSalmonella = 5, int nAggressiveSalmonella = 3, int nEColi = 2);
+
+	// Release one bacterium.  Pits are only woken up by the world's timers,
+	// on the ticks they release something.
 	virtual void doSomething();
-	virtual bool preventsLevelCompleting() const;
+
+	// How many ticks until this pit releases its next bacterium?
+	int ticksUntilNextRelease() const;
 private:
 	int m_nEColi;
 	int m_nRegularSalmonella;
@@ -86,42 +138,21 @@ private:
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class Projectile : public Actor
-{
-public:
-	Projectile(StudentWorld* w, int imageID, double x, double y, int dir, int dist, int power);
-	void doSomething();
-	virtual void beImplemented() const = 0;
-private:
-	int m_travelDistance;
-	int m_damagePower;
-};
-
-//////////////////////////////////////////////////////////////////////////////////////
-
-class Spray : public Projectile
+class Goodie : public Actor
 {
 public:
-	Spray(StudentWorld* w, double x, double y, int dir);
-	virtual void beImplemented() const;
-};
+	Goodie(ActorType type, int imageID, double x, double y);
 
-//////////////////////////////////////////////////////////////////////////////////////
+	// Expire.  Goodies are only woken up by the world's timers, when their
+	// lifetime has run out.
+	void doSomething();
 
-class Flame : public Projectile
-{
-public:
-	Flame(StudentWorld* w, double x, double y, int dir);
-	virtual void beImplemented() const;
-};
+	// Socrates has picked up this goodie.
+	void pickUp(Socrates* socrates);
 
-//////////////////////////////////////////////////////////////////////////////////////
+	// How many ticks does this goodie last?
+	int lifetime() const;
 
-class Goodie : public Actor
-{
-public:
-	Goodie(StudentWorld* w, int imageID, double x, double y);
-	void doSomething();
 	virtual void performSpecialAction(Socrates* socrates) = 0;
 	virtual void playSound();
 private:
@@ -130,37 +161,37 @@ private:
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class RestoreHealthGoodie : public Goodie
+class RestoreHealthGoodie : public Goodie, public Pooled<RestoreHealthGoodie>
 {
 public:
-	RestoreHealthGoodie(StudentWorld* w, double x, double y);
+	RestoreHealthGoodie(double x, double y);
 	virtual void performSpecialAction(Socrates* socrates);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class FlamethrowerGoodie : public Goodie
+class FlamethrowerGoodie : public Goodie, public Pooled<FlamethrowerGoodie>
 {
 public:
-	FlamethrowerGoodie(StudentWorld* w, double x, double y);
+	FlamethrowerGoodie(double x, double y);
 	virtual void performSpecialAction(Socrates* socrates);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class ExtraLifeGoodie : public Goodie
+class ExtraLifeGoodie : public Goodie, public Pooled<ExtraLifeGoodie>
 {
 public:
-	ExtraLifeGoodie(StudentWorld* w, double x, double y);
+	ExtraLifeGoodie(double x, double y);
 	virtual void performSpecialAction(Socrates* socrates);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class Fungus : public Goodie
+class Fungus : public Goodie, public Pooled<Fungus>
 {
 public:
-	Fungus(StudentWorld* w, double x, double y);
+	Fungus(double x, double y);
 	virtual void performSpecialAction(Socrates* socrates);
 	virtual void playSound();
 };
@@ -170,8 +201,8 @@ public:
 class Agent : public Actor
 {
 public:
-	Agent(StudentWorld* w, int imageID, double x, double y, int dir, int hitPoints);
-	virtual bool takeDamage(int damage);
+	Agent(ActorType type, int imageID, double x, double y, int dir, int hitPoints);
+	virtual bool takeDamage(int damage, EventCause cause);
 
 	// How many hit points does this agent currently have?
 	int numHitPoints() const;
@@ -179,14 +210,14 @@ public:
 	// Restore this agent's hit points to their original level
 	void restoreHealth();
 
-	// What sound should play when this agent is damaged but does not die?
-	virtual void playHurt() const = 0;
+	// Play the sound for this agent being damaged but not dying.
+	void playHurt() const;
 
-	// What sound should play when this agent is damaged and dies?
-	virtual void playDead() const = 0;
+	// Play the sound for this agent being damaged and dying.
+	void playDead() const;
 private:
-	int m_hp;
-	int m_maxHP;
+	int16_t m_hp;
+	int16_t m_maxHP;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
@@ -194,7 +225,7 @@ private:
 class Socrates : public Agent
 {
 public:
-	Socrates(StudentWorld* w, double x, double y);
+	Socrates(double x, double y);
 	virtual void doSomething();
 
 	// Increase the number of flamethrower charges the object has.
@@ -205,9 +236,6 @@ public:
 
 	// How many spray charges does the object have?
 	int numSprays() const;
-
-	virtual void playHurt() const;
-	virtual void playDead() const;
 private:
 	int m_nFlames;
 	int m_nSprays;
@@ -219,32 +247,30 @@ private:
 class Bacterium : public Agent
 {
 public:
-	Bacterium(StudentWorld* w, int imageID, double x, double y, int hitPoints);
-	virtual bool preventsLevelCompleting() const;
+	Bacterium(ActorType type, int imageID, double x, double y, int hitPoints);
 	void doSomething();
 	int foodEaten() const;
 	void eatFood();
 	void divide();
-	virtual int getDamage() const = 0;
-	virtual void addBacterium(double newX, double newY) = 0;
-	virtual void doMore() = 0;
-	virtual bool aggressiveSalmonellaOnly() = 0;
+	int getDamage() const;
+	void addBacterium(double newX, double newY);
+	void doMore();
+	bool aggressiveSalmonellaOnly();
 private:
-	int m_foodEaten;
+	int16_t m_foodEaten;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class EColi : public Bacterium
+class EColi : public Bacterium, public Pooled<EColi>
 {
 public:
-	EColi(StudentWorld* w, double x, double y);
-	virtual int getDamage() const;
-	virtual void addBacterium(double newX, double newY);
-	virtual void doMore();
-	virtual void playHurt() const;
-	virtual void playDead() const;
-	virtual bool aggressiveSalmonellaOnly();
+	EColi(double x, double y);
+	void doMore();
+private:
+	// the direction this E. Coli last decided to head in, if it has one
+	int16_t m_plannedAngle;
+	bool m_hasPlan;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
@@ -252,38 +278,29 @@ public:
 class Salmonella : public Bacterium
 {
 public:
-	Salmonella(StudentWorld* w, double x, double y, int hitPoints);
-	virtual int getDamage() const = 0;
-	virtual void addBacterium(double newX, double newY) = 0;
-	virtual void doMore();
-	virtual void playHurt() const;
-	virtual void playDead() const;
-	virtual void attemptMove(int angle);
+	Salmonella(ActorType type, double x, double y, int hitPoints);
+	void doMore();
+	void attemptMove(int angle);
 private:
-	int m_movementPlan;
+	int16_t m_movementPlan;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class RegularSalmonella : public Salmonella
+class RegularSalmonella : public Salmonella, public Pooled<RegularSalmonella>
 {
 public:
-	RegularSalmonella(StudentWorld* w, double x, double y);
-	virtual int getDamage() const;
-	virtual void addBacterium(double newX, double newY);
-	virtual bool aggressiveSalmonellaOnly();
+	RegularSalmonella(double x, double y);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-class AggressiveSalmonella : public Salmonella
+class AggressiveSalmonella : public Salmonella, public Pooled<AggressiveSalmonella>
 {
 public:
-	AggressiveSalmonella(StudentWorld* w, double x, double y);
-	virtual int getDamage() const;
-	virtual void addBacterium(double newX, double newY);
-	virtual bool aggressiveSalmonellaOnly();
-	virtual void attemptMove(int angle);
+	AggressiveSalmonella(double x, double y);
+	bool aggressiveSalmonellaOnly();
+	void attemptMove(int angle);
 };
 
 #endif // ACTOR_INCLUDED
\ No newline at end of file
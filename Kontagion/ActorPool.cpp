@@ -0,0 +1,42 @@
+#include "ActorPool.h"
+#include <algorithm>
+#include <new>
+using namespace std;
+
+/**********************************************************************************/
+/*                       ACTORPOOL CLASS IMPLEMENTATION                           */
+/**********************************************************************************/
+ActorPool::ActorPool(size_t objectSize, size_t alignment)
+{
+	// every slot has to be able to hold the free list's pointer, and start on a suitably aligned address
+	alignment = max(alignment, alignof(void*));
+	m_objectSize = (max(objectSize, sizeof(void*)) + alignment - 1) / alignment * alignment;
+	m_free = nullptr;
+}
+
+void* ActorPool::allocate()
+{
+	if (m_free == nullptr)
+	{
+		// out of room, so add a block and thread all of its slots onto the free list (in address order)
+		char* block = static_cast<char*>(::operator new(m_objectSize * OBJECTS_PER_BLOCK));
+		m_blocks.push_back(block);
+		for (size_t i = OBJECTS_PER_BLOCK; i > 0; i--)
+		{
+			void* slot = block + (i - 1) * m_objectSize;
+			*static_cast<void**>(slot) = m_free;
+			m_free = slot;
+		}
+	}
+	void* p = m_free;
+	m_free = *static_cast<void**>(p);
+	return p;
+}
+
+void ActorPool::deallocate(void* p)
+{
+	if (p == nullptr)
+		return;
+	*static_cast<void**>(p) = m_free;
+	m_free = p;
+}
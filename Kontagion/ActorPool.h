@@ -0,0 +1,68 @@
+#ifndef ACTORPOOL_INCLUDED
+#define ACTORPOOL_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+// Storage for one concrete type of actor.  Actors are carved out of big
+// blocks that hold nothing but that type, so (for example) all the E. coli
+// sit together in a few arrays instead of wherever the heap happened to
+// put them, and making or deleting one just pops or pushes a free list.
+// Blocks are kept once allocated, so a level full of bacteria can be
+// refilled without going back to the heap.
+//
+// Actors are only ever made and deleted by one thread at a time (the tick
+// and level setup never overlap), so the pool doesn't lock.
+class ActorPool
+{
+public:
+	ActorPool(size_t objectSize, size_t alignment);
+
+	void* allocate();
+	void deallocate(void* p);
+
+private:
+	static const size_t OBJECTS_PER_BLOCK = 1024;
+
+	size_t m_objectSize;			// rounded up to keep every object aligned
+	std::vector<char*> m_blocks;
+	void* m_free;					// each free object holds a pointer to the next one
+
+	ActorPool(const ActorPool&);
+	ActorPool& operator=(const ActorPool&);
+};
+
+// Derive a concrete actor class T from Pooled<T> to have new and delete
+// put it in T's own pool.  Building with KONTAGION_HEAP_ACTORS defined
+// leaves every actor on the ordinary heap instead, for comparison.
+template<typename T>
+class Pooled
+{
+public:
+#ifndef KONTAGION_HEAP_ACTORS
+	static void* operator new(size_t size)
+	{
+		// a class derived from T would be bigger than T's slots
+		if (size != sizeof(T))
+			return ::operator new(size);
+		return pool().allocate();
+	}
+
+	static void operator delete(void* p, size_t size)
+	{
+		if (size != sizeof(T))
+			::operator delete(p);
+		else
+			pool().deallocate(p);
+	}
+#endif
+
+	static ActorPool& pool()
+	{
+		// never destroyed, so an actor deleted while the program is exiting still has somewhere to go
+		static ActorPool* p = new ActorPool(sizeof(T), alignof(T));
+		return *p;
+	}
+};
+
+#endif // ACTORPOOL_INCLUDED
@@ -0,0 +1,115 @@
+#include "ActorSlotMap.h"
+#include <algorithm>
+#include <numeric>
+using namespace std;
+
+/**********************************************************************************/
+/*                    ACTORSLOTMAP CLASS IMPLEMENTATION                           */
+/**********************************************************************************/
+ActorHandle ActorSlotMap::insert(Actor* a)
+{
+	// reuse a free slot if there is one; otherwise, make a new one
+	int slot;
+	if (!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = m_slots.size();
+		Slot s;
+		s.generation = 1;
+		s.position = -1;
+		m_slots.push_back(s);
+	}
+	m_slots[slot].position = m_actors.size();
+	m_actors.push_back(a);
+	m_slotOf.push_back(slot);
+	ActorHandle h;
+	h.index = slot;
+	h.generation = m_slots[slot].generation;
+	return h;
+}
+
+Actor* ActorSlotMap::get(ActorHandle h) const
+{
+	if (h.index < 0 || h.index >= (int)m_slots.size())
+		return nullptr;
+	const Slot& s = m_slots[h.index];
+	// a different generation means the actor this handle referred to is gone
+	if (s.generation != h.generation || s.position < 0)
+		return nullptr;
+	return m_actors[s.position];
+}
+
+void ActorSlotMap::erase(ActorHandle h)
+{
+	if (get(h) == nullptr)
+		return;
+	Slot& s = m_slots[h.index];
+	int position = s.position;
+	// move the last actor into the hole so the array stays packed
+	int last = m_actors.size() - 1;
+	m_actors[position] = m_actors[last];
+	m_slotOf[position] = m_slotOf[last];
+	m_slots[m_slotOf[position]].position = position;
+	m_actors.pop_back();
+	m_slotOf.pop_back();
+	// bump the generation so old handles to this slot stop working
+	s.position = -1;
+	s.generation++;
+	m_freeSlots.push_back(h.index);
+}
+
+void ActorSlotMap::clear()
+{
+	// keep the slots (and their generations) so handles from before the clear stay invalid
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		if (m_slots[i].position >= 0)
+		{
+			m_slots[i].position = -1;
+			m_slots[i].generation++;
+			m_freeSlots.push_back(i);
+		}
+	}
+	m_actors.clear();
+	m_slotOf.clear();
+}
+
+int ActorSlotMap::size() const
+{
+	return m_actors.size();
+}
+
+Actor* ActorSlotMap::at(int i) const
+{
+	return m_actors[i];
+}
+
+int ActorSlotMap::positionOf(ActorHandle h) const
+{
+	if (get(h) == nullptr)
+		return -1;
+	return m_slots[h.index].position;
+}
+
+void ActorSlotMap::sortByKey(const vector<unsigned int>& keys)
+{
+	// work out the new order, then move the actors (and their slot numbers) into it
+	vector<int> order(m_actors.size());
+	iota(order.begin(), order.end(), 0);
+	stable_sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+	vector<Actor*> actors(m_actors.size());
+	vector<int> slotOf(m_slotOf.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		actors[i] = m_actors[order[i]];
+		slotOf[i] = m_slotOf[order[i]];
+		// the slot has to know where its actor went
+		m_slots[slotOf[i]].position = i;
+	}
+	m_actors.swap(actors);
+	m_slotOf.swap(slotOf);
+}
@@ -0,0 +1,70 @@
+#ifndef ACTORSLOTMAP_INCLUDED
+#define ACTORSLOTMAP_INCLUDED
+
+#include <vector>
+
+class Actor;
+
+// A reference to an actor that is safe to hold on to across ticks.  Once the
+// actor is removed from the world, looking the handle up gives nullptr, even
+// if its slot has since been reused by a new actor.
+struct ActorHandle
+{
+	int index = -1;
+	unsigned int generation = 0;
+
+	bool operator==(const ActorHandle& other) const
+	{
+		return index == other.index && generation == other.generation;
+	}
+};
+
+// Owns no actors; it just keeps track of them.  The actors themselves are
+// packed into one contiguous array (so iterating over them doesn't chase
+// list nodes), and each handle points at a slot that knows where in that
+// array its actor currently is.  Removing an actor moves the last actor
+// into its place.
+class ActorSlotMap
+{
+public:
+	// Add an actor and return a handle to it.
+	ActorHandle insert(Actor* a);
+
+	// Return the actor the handle refers to, or nullptr if it has been removed.
+	Actor* get(ActorHandle h) const;
+
+	// Remove the actor the handle refers to (if it's still here).  The last
+	// actor in the array takes its place.
+	void erase(ActorHandle h);
+
+	// Remove every actor.
+	void clear();
+
+	// How many actors are there?
+	int size() const;
+
+	// Return the actor at position i of the packed array.
+	Actor* at(int i) const;
+
+	// Return where in the packed array the actor the handle refers to is,
+	// or -1 if it has been removed.
+	int positionOf(ActorHandle h) const;
+
+	// Rearrange the packed array so the actors are in increasing order of
+	// keys, where keys[i] is the key for the actor at position i.  Handles
+	// stay valid.
+	void sortByKey(const std::vector<unsigned int>& keys);
+
+private:
+	struct Slot
+	{
+		unsigned int generation;
+		int position;	// where the actor is in m_actors, or -1 if the slot is free
+	};
+	std::vector<Slot> m_slots;
+	std::vector<int> m_freeSlots;
+	std::vector<Actor*> m_actors;	// packed, in update order
+	std::vector<int> m_slotOf;		// which slot each entry of m_actors belongs to
+};
+
+#endif // ACTORSLOTMAP_INCLUDED
@@ -0,0 +1,172 @@
+#include "AssetPack.h"
+#include <cstring>
+using namespace std;
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::AssetPack()
+ : m_data(nullptr), m_size(0), m_entries(nullptr), m_count(0)
+#ifdef _MSC_VER
+   , m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#endif
+{
+}
+
+AssetPack::~AssetPack()
+{
+    close();
+}
+
+bool AssetPack::open(const string& filename)
+{
+    close();
+
+#ifdef _MSC_VER
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat statbuf;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &statbuf) == 0 && statbuf.st_size > 0)
+        data = mmap(nullptr, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // the mapping keeps the file open
+    if (data != MAP_FAILED)
+    {
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = statbuf.st_size;
+    }
+#endif
+    if (m_data == nullptr)
+    {
+        close();
+        return false;
+    }
+
+      // Check everything once here, so lookups can trust the index.
+    PackHeader header;
+    if (m_size < sizeof(header))
+    {
+        close();
+        return false;
+    }
+    memcpy(&header, m_data, sizeof(header));
+    if (memcmp(header.magic, "KPAK", 4) != 0 || header.version != PACK_VERSION
+        || header.count > (m_size - sizeof(header)) / sizeof(PackEntry))
+    {
+        close();
+        return false;
+    }
+    m_entries = reinterpret_cast<const PackEntry*>(m_data + sizeof(header));
+    m_count = header.count;
+    for (uint32_t i = 0; i < m_count; i++)
+    {
+        const PackEntry& e = m_entries[i];
+        bool ok = e.name[PACK_NAME_LENGTH - 1] == '\0' && e.offset <= m_size && e.size <= m_size - e.offset
+                  && e.offset % PACK_ALIGNMENT == 0 && (i == 0 || strcmp(m_entries[i - 1].name, e.name) < 0);
+        if (ok && e.type == PACK_SPRITE)
+        {
+            ok = e.levels > 0 && e.levels <= e.size / sizeof(PackMipLevel);
+            const PackMipLevel* levels = reinterpret_cast<const PackMipLevel*>(m_data + e.offset);
+            for (uint32_t k = 0; ok && k < e.levels; k++)
+            {
+                uint64_t bytes = 4ull * levels[k].width * levels[k].height;
+                ok = levels[k].offset >= e.offset && levels[k].offset <= e.offset + e.size
+                     && bytes <= e.offset + e.size - levels[k].offset;
+            }
+        }
+        if (!ok)
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close()
+{
+#ifdef _MSC_VER
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_count = 0;
+}
+
+bool AssetPack::findSprite(const string& name, vector<MipLevelView>& levels) const
+{
+    const PackEntry* e = find(name, PACK_SPRITE);
+    if (e == nullptr)
+        return false;
+    const PackMipLevel* mips = reinterpret_cast<const PackMipLevel*>(m_data + e->offset);
+    levels.clear();
+    for (uint32_t k = 0; k < e->levels; k++)
+    {
+        MipLevelView level = { static_cast<int>(mips[k].width), static_cast<int>(mips[k].height), m_data + mips[k].offset };
+        levels.push_back(level);
+    }
+    return true;
+}
+
+bool AssetPack::findFile(const string& name, const void*& data, size_t& size) const
+{
+    const PackEntry* e = find(name, PACK_FILE);
+    if (e == nullptr)
+        return false;
+    data = m_data + e->offset;
+    size = static_cast<size_t>(e->size);
+    return true;
+}
+
+const PackEntry* AssetPack::find(const string& name, uint32_t type) const
+{
+      // binary search of the sorted index
+    uint32_t lo = 0, hi = m_count;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(m_entries[mid].name, name.c_str());
+        if (cmp == 0)
+            return m_entries[mid].type == type ? &m_entries[mid] : nullptr;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return nullptr;
+}
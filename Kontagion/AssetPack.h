@@ -0,0 +1,90 @@
+#ifndef ASSETPACK_H_
+#define ASSETPACK_H_
+
+#include "SpriteImage.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+  // The pack the game looks for in the Assets directory.  Tools/PackAssets
+  // makes it; without it, the game loads the loose TGA and WAV files.
+const char* const ASSET_PACK_NAME = "kontagion.pak";
+
+  // kontagion.pak is laid out as (all integers little-endian):
+  //
+  //     PackHeader
+  //     PackEntry[count], sorted by name
+  //     each entry's data, starting on a PACK_ALIGNMENT boundary
+  //
+  // A sprite's data is PackMipLevel[levels] followed by each level's BGRA
+  // texels, bottom row first, ready to hand to OpenGL as they are.  Any
+  // other file's data is just the file's bytes.
+const std::uint32_t PACK_VERSION = 1;
+const std::size_t   PACK_ALIGNMENT = 16;
+const std::size_t   PACK_NAME_LENGTH = 48;
+
+enum PackEntryType : std::uint32_t { PACK_SPRITE = 0, PACK_FILE = 1 };
+
+struct PackHeader
+{
+    char          magic[4];         // "KPAK"
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+struct PackEntry
+{
+    char          name[PACK_NAME_LENGTH];   // file name in the Assets directory, '\0' padded
+    std::uint32_t type;
+    std::uint32_t levels;           // mipmap levels, for sprites
+    std::uint64_t offset;           // from the start of the pack
+    std::uint64_t size;
+};
+
+struct PackMipLevel
+{
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint64_t offset;           // of the texels, from the start of the pack
+};
+
+  // A read-only asset pack, memory mapped, so sprites are handed out as
+  // pointers into the file with nothing copied.  Those pointers are good
+  // until the pack is closed.
+class AssetPack
+{
+  public:
+    AssetPack();
+    ~AssetPack();
+
+      // Map the pack and check that its index makes sense; false if the
+      // file is missing or isn't a pack this version understands.
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+      // A sprite's mipmap chain, full size first.
+    bool findSprite(const std::string& name, std::vector<MipLevelView>& levels) const;
+
+      // Any other file's bytes.
+    bool findFile(const std::string& name, const void*& data, std::size_t& size) const;
+
+  private:
+    const std::uint8_t* m_data;
+    std::size_t         m_size;
+    const PackEntry*    m_entries;
+    std::uint32_t       m_count;
+#ifdef _MSC_VER
+    void*               m_file;
+    void*               m_mapping;
+#endif
+
+    const PackEntry* find(const std::string& name, std::uint32_t type) const;
+
+    AssetPack(const AssetPack&);
+    AssetPack& operator=(const AssetPack&);
+};
+
+#endif // ASSETPACK_H_
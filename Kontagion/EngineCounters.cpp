@@ -0,0 +1,60 @@
+#include "EngineCounters.h"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+using namespace std;
+
+#ifdef KONTAGION_COUNTERS
+CounterSnapshot g_engineCounterTotals = {};
+#endif
+
+static const char* const COUNTER_NAMES[NUM_ENGINE_COUNTERS] =
+{
+	"movement blocked queries", "damage queries", "edible queries", "distance checks",
+	"actor comparisons", "actors created", "actors destroyed",
+};
+
+/**********************************************************************************/
+/*                      ENGINECOUNTERS CLASS IMPLEMENTATION                       */
+/**********************************************************************************/
+EngineCounters::EngineCounters()
+	: m_lastTick(), m_totalsBefore(), m_worst()
+{
+	m_ticks = 0;
+}
+
+void EngineCounters::endTick()
+{
+#ifdef KONTAGION_COUNTERS
+	for (int i = 0; i < NUM_ENGINE_COUNTERS; i++)
+	{
+		m_lastTick.values[i] = g_engineCounterTotals.values[i] - m_totalsBefore.values[i];
+		m_worst.values[i] = max(m_worst.values[i], m_lastTick.values[i]);
+	}
+	m_totalsBefore = g_engineCounterTotals;
+	m_ticks++;
+#endif
+}
+
+const CounterSnapshot& EngineCounters::lastTick() const
+{
+	return m_lastTick;
+}
+
+string EngineCounters::report() const
+{
+#ifdef KONTAGION_COUNTERS
+	ostringstream oss;
+	oss << "Engine counters over " << m_ticks << " ticks:" << endl;
+	oss << "  " << left << setw(26) << "counter" << right << setw(14) << "total" << setw(12) << "per tick" << setw(12) << "worst tick" << endl;
+	for (int i = 0; i < NUM_ENGINE_COUNTERS; i++)
+	{
+		oss << "  " << left << setw(26) << COUNTER_NAMES[i] << right << setw(14) << m_totalsBefore.values[i]
+			<< setw(12) << fixed << setprecision(1) << (m_ticks > 0 ? m_totalsBefore.values[i] / double(m_ticks) : 0.0)
+			<< setw(12) << m_worst.values[i] << endl;
+	}
+	return oss.str();
+#else
+	return "";
+#endif
+}
@@ -0,0 +1,62 @@
+#ifndef ENGINECOUNTERS_INCLUDED
+#define ENGINECOUNTERS_INCLUDED
+
+#include <string>
+
+// Counts of how often the world's queries run and how much work they do,
+// for finding out where the time goes.  Building with KONTAGION_COUNTERS
+// defined turns them on; otherwise COUNT_EVENT compiles to nothing, so the
+// counters cost nothing at all unless they're wanted.
+//
+// The totals are plain numbers, not atomics: everything counted happens in
+// the part of the tick that runs one job after another (see
+// StudentWorld::buildTickGraph), never in two threads at once.
+enum EngineCounter
+{
+	COUNTER_BLOCKED_QUERIES,	// calls to StudentWorld::isBacteriumMovementBlockedAt
+	COUNTER_DAMAGE_QUERIES,		// calls to StudentWorld::damageOneActor
+	COUNTER_EDIBLE_QUERIES,		// calls to StudentWorld::getOverlappingEdible
+	COUNTER_DISTANCE_CHECKS,	// calls to Actor::getDistance
+	COUNTER_ACTOR_COMPARISONS,	// other actors the world's queries looked at
+	COUNTER_ACTORS_CREATED,
+	COUNTER_ACTORS_DESTROYED,
+	NUM_ENGINE_COUNTERS
+};
+
+struct CounterSnapshot
+{
+	long long values[NUM_ENGINE_COUNTERS];
+};
+
+#ifdef KONTAGION_COUNTERS
+extern CounterSnapshot g_engineCounterTotals;	// everything counted since the game started
+#define COUNT_EVENT(counter) (g_engineCounterTotals.values[counter]++)
+#else
+#define COUNT_EVENT(counter) ((void)0)
+#endif
+
+// Turns the running totals into per-tick numbers.
+class EngineCounters
+{
+public:
+	EngineCounters();
+
+	// Call at the end of every tick.  (Whatever is counted between ticks,
+	// such as setting up a level, goes into the next tick.)
+	void endTick();
+
+	// What was counted during the last tick (all zeros if counters are off).
+	const CounterSnapshot& lastTick() const;
+
+	// A table of each counter's total, per-tick mean and busiest tick, or
+	// "" if counters are off.  It's printed when the world is destroyed.
+	std::string report() const;
+
+private:
+	CounterSnapshot m_lastTick;
+	CounterSnapshot m_totalsBefore;		// the totals as of the end of the tick before
+	CounterSnapshot m_worst;
+	long m_ticks;
+};
+
+#endif // ENGINECOUNTERS_INCLUDED
@@ -0,0 +1,132 @@
+#include "EventLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+using namespace std;
+
+const char* const EVENT_KIND_NAMES[NUM_EVENT_KINDS] =
+{
+	"spawn", "death", "damage", "food eaten", "division", "goodie pickup", "level complete",
+};
+
+const char* const EVENT_CAUSE_NAMES[NUM_EVENT_CAUSES] =
+{
+	"none", "pit", "division", "remains", "spray", "flame", "bacterium", "fungus",
+	"eaten", "picked up", "expired", "emptied",
+};
+
+/**********************************************************************************/
+/*                         EVENTLOG CLASS IMPLEMENTATION                          */
+/**********************************************************************************/
+EventLog::EventLog()
+	: m_open(false), m_stopping(false), m_written(0), m_dropped(0)
+{
+}
+
+EventLog::~EventLog()
+{
+	close();
+}
+
+bool EventLog::open(const string& filename, const char* const typeNames[], int numTypes)
+{
+	close();
+	if (numTypes > EVENT_LOG_MAX_TYPES)
+		return false;
+	m_file.open(filename, ios::out | ios::binary | ios::trunc);
+	if (!m_file)
+		return false;
+	EventLogHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "KEVT", 4);
+	header.version = EVENT_LOG_VERSION;
+	header.eventBytes = sizeof(GameEvent);
+	header.numTypes = numTypes;
+	for (int i = 0; i < numTypes; i++)
+		strncpy(header.typeNames[i], typeNames[i], EVENT_LOG_TYPE_NAME_LENGTH - 1);
+	m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	m_ring.reset(new Ring);
+	m_written = 0;
+	m_dropped = 0;
+	m_stopping = false;
+	m_open = true;
+	m_writer = thread([this]() { writerLoop(); });
+	return true;
+}
+
+void EventLog::close()
+{
+	if (!m_open)
+		return;
+	{
+		lock_guard<mutex> lock(m_wakeLock);
+		m_stopping = true;
+	}
+	m_wake.notify_one();
+	m_writer.join();
+	m_file.close();
+	m_ring.reset();
+	m_open = false;
+}
+
+bool EventLog::isOpen() const
+{
+	return m_open;
+}
+
+void EventLog::record(const GameEvent& e)
+{
+	Ring* r = m_ring.get();
+	size_t tail = r->tail.load(memory_order_relaxed);
+	if (tail - r->head.load(memory_order_acquire) == RING_EVENTS)
+	{
+		m_dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+	r->events[tail & (RING_EVENTS - 1)] = e;
+	r->tail.store(tail + 1, memory_order_release);
+}
+
+long EventLog::written() const
+{
+	return m_written;
+}
+
+long EventLog::dropped() const
+{
+	return m_dropped.load(memory_order_relaxed);
+}
+
+void EventLog::drain()
+{
+	Ring* r = m_ring.get();
+	size_t head = r->head.load(memory_order_relaxed);
+	size_t tail = r->tail.load(memory_order_acquire);
+	// the waiting events are at most two runs: up to the end of the array, then from its start
+	while (head != tail)
+	{
+		size_t start = head & (RING_EVENTS - 1);
+		size_t n = min(tail - head, RING_EVENTS - start);
+		m_file.write(reinterpret_cast<const char*>(&r->events[start]), n * sizeof(GameEvent));
+		head += n;
+		m_written += n;
+	}
+	r->head.store(head, memory_order_release);
+}
+
+void EventLog::writerLoop()
+{
+	unique_lock<mutex> lock(m_wakeLock);
+	while (!m_stopping)
+	{
+		m_wake.wait_for(lock, chrono::milliseconds((int)WRITE_INTERVAL_MS));
+		lock.unlock();
+		drain();
+		lock.lock();
+	}
+	lock.unlock();
+	// the game has stopped recording, so this gets everything
+	drain();
+	m_file.flush();
+}
@@ -0,0 +1,139 @@
+#ifndef EVENTLOG_INCLUDED
+#define EVENTLOG_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// What happened.
+enum EventKind
+{
+	EVENT_SPAWN,
+	EVENT_DEATH,
+	EVENT_DAMAGE,
+	EVENT_FOOD_EATEN,
+	EVENT_DIVISION,
+	EVENT_GOODIE_PICKUP,
+	EVENT_LEVEL_COMPLETE,
+	NUM_EVENT_KINDS
+};
+
+// Why it happened (or what did it).
+enum EventCause
+{
+	CAUSE_NONE,
+	CAUSE_PIT,			// spawned: released by a pit
+	CAUSE_DIVISION,		// spawned: a bacterium divided
+	CAUSE_REMAINS,		// spawned: food left where a bacterium was killed
+	CAUSE_SPRAY,		// damaged or killed by disinfectant spray
+	CAUSE_FLAME,		// damaged or killed by a flame
+	CAUSE_BACTERIUM,	// damaged or killed by a bacterium
+	CAUSE_FUNGUS,		// damaged or killed by fungus
+	CAUSE_EATEN,		// died: food a bacterium ate
+	CAUSE_PICKED_UP,	// died: a goodie Socrates picked up
+	CAUSE_EXPIRED,		// died: a goodie nobody picked up in time
+	CAUSE_EMPTIED,		// died: a pit with nothing left to release
+	NUM_EVENT_CAUSES
+};
+
+extern const char* const EVENT_KIND_NAMES[NUM_EVENT_KINDS];
+extern const char* const EVENT_CAUSE_NAMES[NUM_EVENT_CAUSES];
+
+const int EVENT_NO_ACTOR = 255;		// for GameEvent::other when nothing else took part
+const std::uint32_t EVENT_LOG_VERSION = 1;
+const int EVENT_LOG_MAX_TYPES = 16;
+const int EVENT_LOG_TYPE_NAME_LENGTH = 24;
+
+// One event, exactly as it's stored in the log.
+struct GameEvent
+{
+	std::uint32_t tick;		// ticks since the level started
+	std::uint16_t level;
+	std::uint8_t kind;		// an EventKind
+	std::uint8_t cause;		// an EventCause
+	std::uint8_t actor;		// the ActorType it happened to
+	std::uint8_t other;		// the ActorType of whatever else took part (e.g., what ate the food), or EVENT_NO_ACTOR
+	std::int16_t amount;	// damage done, or points scored
+	std::int16_t x;			// where it happened, in pixels
+	std::int16_t y;
+};
+
+// The log file is an EventLogHeader followed by GameEvents until the end,
+// in the order they happened.
+struct EventLogHeader
+{
+	char magic[4];			// "KEVT"
+	std::uint32_t version;
+	std::uint32_t eventBytes;	// sizeof(GameEvent), so readers can check they agree
+	std::uint32_t numTypes;
+	char typeNames[EVENT_LOG_MAX_TYPES][EVENT_LOG_TYPE_NAME_LENGTH];	// what each ActorType is called
+};
+
+// A binary log of gameplay events.  The simulation adds events to a ring
+// without taking a lock, and a background thread empties the ring into the
+// file every so often, so the game never waits for the disk.  If the ring
+// fills up anyway (the writer has fallen far behind), events are dropped
+// and counted rather than waited for.
+//
+// Events are only recorded while setting up a level and by the parts of
+// the tick that run one after another (see StudentWorld::buildTickGraph).
+// Those can run on different threads from one tick to the next, but never
+// at the same time, so the ring only ever has one producer.
+class EventLog
+{
+public:
+	EventLog();
+	~EventLog();
+
+	// Start a log in the indicated file; typeNames[i] is what ActorType i
+	// is called.  Return false if the file can't be written.
+	bool open(const std::string& filename, const char* const typeNames[], int numTypes);
+
+	// Write out everything recorded so far and stop the writer thread.
+	void close();
+
+	bool isOpen() const;
+
+	// Add an event to the log (never blocks; calls must not overlap).
+	void record(const GameEvent& e);
+
+	// How many events have been written, and how many were lost because
+	// the ring was full?
+	long written() const;
+	long dropped() const;
+
+private:
+	static const std::size_t RING_EVENTS = 65536;	// must be a power of two
+	static const int WRITE_INTERVAL_MS = 20;
+
+	// a ring with one producer (the simulation) and one consumer (the writer)
+	struct Ring
+	{
+		GameEvent events[RING_EVENTS];
+		std::atomic<std::size_t> head;		// next event to write out; only the writer changes it
+		std::atomic<std::size_t> tail;		// next free spot; only the producer changes it
+		Ring() : head(0), tail(0) {}
+	};
+
+	bool m_open;
+	std::unique_ptr<Ring> m_ring;
+	std::ofstream m_file;
+	std::thread m_writer;
+	std::mutex m_wakeLock;
+	std::condition_variable m_wake;
+	bool m_stopping;
+	long m_written;							// only the writer touches this until it's stopped
+	std::atomic<long> m_dropped;
+
+	// writer: move everything in the ring to the file
+	void drain();
+	void writerLoop();
+};
+
+#endif // EVENTLOG_INCLUDED
@@ -0,0 +1,113 @@
+#include "FixedPoint.h"
+#include <cmath>
+using namespace std;
+
+// sin(0) through sin(90 degrees) in 16.16 fixed point, rounded to nearest;
+// the rest of the circle is folded onto these
+static const Fixed SIN_TABLE[91] =
+{
+	0, 1144, 2287, 3430, 4572, 5712, 6850, 7987, 9121, 10252,
+	11380, 12505, 13626, 14742, 15855, 16962, 18064, 19161, 20252, 21336,
+	22415, 23486, 24550, 25607, 26656, 27697, 28729, 29753, 30767, 31772,
+	32768, 33754, 34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+	42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930, 48703, 49461,
+	50203, 50931, 51643, 52339, 53020, 53684, 54332, 54963, 55578, 56175,
+	56756, 57319, 57865, 58393, 58903, 59396, 59870, 60326, 60764, 61183,
+	61584, 61966, 62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+	64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446, 65496, 65526,
+	65536,
+};
+
+Fixed fixedFromDouble(double d)
+{
+	// multiplying by a power of two is exact, so this rounds the same way everywhere
+	return (Fixed)floor(d * FIXED_ONE + 0.5);
+}
+
+double fixedToDouble(Fixed f)
+{
+	return f / (double)FIXED_ONE;
+}
+
+Fixed fixedSin(int degrees)
+{
+	// make sure angle is between 0 and 360
+	int d = degrees % 360;
+	if (d < 0)
+		d += 360;
+	if (d <= 90)
+		return SIN_TABLE[d];
+	if (d <= 180)
+		return SIN_TABLE[180 - d];
+	if (d <= 270)
+		return -SIN_TABLE[d - 180];
+	return -SIN_TABLE[360 - d];
+}
+
+Fixed fixedCos(int degrees)
+{
+	return fixedSin(degrees + 90);
+}
+
+int64_t fixedDistanceSquared(Fixed x0, Fixed y0, Fixed x1, Fixed y1)
+{
+	int64_t dx = (int64_t)x1 - x0;
+	int64_t dy = (int64_t)y1 - y0;
+	return dx * dx + dy * dy;
+}
+
+uint64_t integerSqrt(uint64_t n)
+{
+	// one bit at a time
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+	while (bit > n)
+		bit >>= 2;
+	while (bit != 0)
+	{
+		if (n >= root + bit)
+		{
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+Fixed fixedDistance(Fixed x0, Fixed y0, Fixed x1, Fixed y1)
+{
+	// the square of a distance in 1/65536ths has its square root in 1/65536ths, so no shifting is needed
+	return (Fixed)integerSqrt(fixedDistanceSquared(x0, y0, x1, y1));
+}
+
+int fixedAngleDegrees(Fixed dy, Fixed dx)
+{
+	// atan2(0, 0) is 0
+	if (dx == 0 && dy == 0)
+		return 0;
+	int64_t ax = dx < 0 ? -(int64_t)dx : dx;
+	int64_t ay = dy < 0 ? -(int64_t)dy : dy;
+	// find the whole part of the angle from the x axis to (ax, ay): the
+	// biggest d from 0 to 90 with tan(d) <= ay / ax, i.e., with
+	// ay * cos(d) >= ax * sin(d)
+	int low = 0;
+	int high = 90;
+	while (low < high)
+	{
+		int mid = (low + high + 1) / 2;
+		if (ay * SIN_TABLE[90 - mid] >= ax * SIN_TABLE[mid])
+			low = mid;
+		else
+			high = mid - 1;
+	}
+	int whole = low;
+	bool exact = ay * SIN_TABLE[90 - whole] == ax * SIN_TABLE[whole];
+	// unfold into the quadrant (dx, dy) is in, rounding toward zero
+	int angle = dx >= 0 ? whole : 180 - (exact ? whole : whole + 1);
+	return dy < 0 ? -angle : angle;
+}
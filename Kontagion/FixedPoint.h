@@ -0,0 +1,60 @@
+#ifndef FIXEDPOINT_INCLUDED
+#define FIXEDPOINT_INCLUDED
+
+#include <cstdint>
+
+// 16.16 fixed-point numbers: the top 16 bits are the whole part and the
+// bottom 16 bits are the fraction, so 1.0 is 65536.  The Petri dish is 256
+// pixels across (at most 16384 with -dishRadius), so every position fits.
+//
+// Building with KONTAGION_FIXED_POINT defined makes GraphObject keep actor
+// positions in this form (Coord is then Fixed instead of double), and makes
+// moving, distances, overlaps and angles between actors use only the integer
+// functions below, as do the dish's edge, placing actors, the paths of sprays
+// and flames, and the pits' release timing.  Sines and cosines come from a
+// hard-coded table instead of the math library, so a game played from the
+// same random seed with the same input comes out exactly the same on every
+// compiler and platform.  (What's left in floating point is only copying
+// exact values around and comparing them, which IEEE doubles do the same
+// everywhere.)
+typedef int32_t Fixed;
+
+const int FIXED_FRACTION_BITS = 16;
+const Fixed FIXED_ONE = 1 << FIXED_FRACTION_BITS;
+
+// Convert to and from fixed point; fixedFromDouble rounds to the nearest
+// 1/65536.  Converting a Fixed to a double and back always gives back the
+// same Fixed.
+Fixed fixedFromDouble(double d);
+double fixedToDouble(Fixed f);
+
+// sin and cos of a whole number of degrees (any number, not just 0-359)
+Fixed fixedSin(int degrees);
+Fixed fixedCos(int degrees);
+
+// The square root of n, rounded down.
+uint64_t integerSqrt(uint64_t n);
+
+// The square of the distance between two points, in 1/65536ths squared,
+// and the distance itself (rounded down to the nearest 1/65536).
+int64_t fixedDistanceSquared(Fixed x0, Fixed y0, Fixed x1, Fixed y1);
+Fixed fixedDistance(Fixed x0, Fixed y0, Fixed x1, Fixed y1);
+
+// The direction from the origin to (dx, dy) in degrees, rounded toward zero,
+// like (int)(atan2(dy, dx) * 180 / PI).  Since the table is only accurate to
+// 1/65536, it can be one degree off when the angle is within a hair of a
+// whole number of degrees.
+int fixedAngleDegrees(Fixed dy, Fixed dx);
+
+// The type GraphObject stores positions in.
+#ifdef KONTAGION_FIXED_POINT
+typedef Fixed Coord;
+inline Coord coordFromDouble(double d) { return fixedFromDouble(d); }
+inline double coordToDouble(Coord c) { return fixedToDouble(c); }
+#else
+typedef double Coord;
+inline Coord coordFromDouble(double d) { return d; }
+inline double coordToDouble(Coord c) { return c; }
+#endif
+
+#endif // FIXEDPOINT_INCLUDED
@@ -0,0 +1,170 @@
+#include "FrameRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+using namespace std;
+
+FrameRecorder::FrameRecorder(string prefix, int maxQueuedFrames)
+ : m_prefix(prefix), m_frames(max(1, maxQueuedFrames)), m_stopping(false),
+   m_written(0), m_dropped(0), m_failed(0), m_bytes(0), m_encodeMs(0), m_worstEncodeMs(0)
+{
+    for (Frame& f : m_frames)
+        m_free.push_back(&f);
+    m_thread = thread(&FrameRecorder::encoderLoop, this);
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    finish();
+}
+
+void FrameRecorder::finish()
+{
+    if (!m_thread.joinable())
+        return;
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_stopping = true;
+    }
+    m_frameQueued.notify_one();
+    m_thread.join();
+}
+
+bool FrameRecorder::submit(const uint8_t* bgra, int width, int height, bool waitIfFull)
+{
+    Frame* frame;
+    {
+        unique_lock<mutex> guard(m_lock);
+        if (m_free.empty())
+        {
+            if (!waitIfFull)
+            {
+                m_dropped++;
+                return false;
+            }
+            m_frameFreed.wait(guard, [this]() { return !m_free.empty(); });
+        }
+        frame = m_free.back();
+        m_free.pop_back();
+    }
+
+      // Nobody else can see this buffer now, so copy without the lock held.
+    frame->width = width;
+    frame->height = height;
+    frame->pixels.resize(width * height);
+    memcpy(frame->pixels.data(), bgra, 4 * width * height);
+
+    {
+        lock_guard<mutex> guard(m_lock);
+        m_queued.push_back(frame);
+    }
+    m_frameQueued.notify_one();
+    return true;
+}
+
+string FrameRecorder::report() const
+{
+    lock_guard<mutex> guard(m_lock);
+    ostringstream oss;
+    oss << "Capture: " << m_written << " frames written to " << m_prefix << "*.tga ("
+        << m_bytes / (1024 * 1024) << " MB), " << m_dropped << " dropped";
+    if (m_failed > 0)
+        oss << ", " << m_failed << " failed to write";
+    if (m_written > 0)
+        oss << "; encoding took " << m_encodeMs / m_written << " ms per frame, worst " << m_worstEncodeMs << " ms";
+    return oss.str();
+}
+
+void FrameRecorder::encoderLoop()
+{
+    for (long number = 0; ; number++)
+    {
+        Frame* frame;
+        {
+            unique_lock<mutex> guard(m_lock);
+            m_frameQueued.wait(guard, [this]() { return m_stopping || !m_queued.empty(); });
+            if (m_queued.empty())
+                return;     // stopping, and everything's been written
+            frame = m_queued.front();
+            m_queued.pop_front();
+        }
+
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), "%05ld.tga", number);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        size_t bytes = 0;
+        bool ok = writeTGA(*frame, m_prefix + suffix, bytes);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        {
+            lock_guard<mutex> guard(m_lock);
+            if (ok)
+            {
+                m_written++;
+                m_bytes += bytes;
+                m_encodeMs += ms;
+                m_worstEncodeMs = max(m_worstEncodeMs, ms);
+            }
+            else
+                m_failed++;
+            m_free.push_back(frame);
+        }
+        m_frameFreed.notify_one();
+    }
+}
+
+bool FrameRecorder::writeTGA(const Frame& frame, const string& filename, size_t& bytes)
+{
+      // Run-length encoded true color (type 10), 32 bits per pixel (BGRA)
+      // with 8 of them alpha, bottom row first.  Each row is packed
+      // separately: a run of 2 to 128 identical pixels becomes a header
+      // byte and one pixel, and anything else is copied in packets of up
+      // to 128.
+    unsigned char header[18] = { 0 };
+    header[2] = 10;
+    header[12] = frame.width & 0xFF;
+    header[13] = (frame.width >> 8) & 0xFF;
+    header[14] = frame.height & 0xFF;
+    header[15] = (frame.height >> 8) & 0xFF;
+    header[16] = 32;
+    header[17] = 8;
+
+    vector<unsigned char> out(header, header + sizeof(header));
+    out.reserve(sizeof(header) + 4 * frame.width * frame.height + frame.height * (frame.width / 128 + 1));
+    for (int y = 0; y < frame.height; y++)
+    {
+        const uint32_t* row = &frame.pixels[y * frame.width];
+        int x = 0;
+        while (x < frame.width)
+        {
+            int run = 1;
+            while (x + run < frame.width && run < 128 && row[x + run] == row[x])
+                run++;
+            if (run > 1)
+            {
+                out.push_back(static_cast<unsigned char>(0x80 | (run - 1)));
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(&row[x]);
+                out.insert(out.end(), p, p + 4);
+                x += run;
+                continue;
+            }
+              // copy pixels up to the next pair of identical ones
+            int count = 1;
+            while (x + count < frame.width && count < 128
+                   && !(x + count + 1 < frame.width && row[x + count] == row[x + count + 1]))
+                count++;
+            out.push_back(static_cast<unsigned char>(count - 1));
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(&row[x]);
+            out.insert(out.end(), p, p + 4 * count);
+            x += count;
+        }
+    }
+
+    ofstream file(filename, ios::out | ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    bytes = out.size();
+    return static_cast<bool>(file);
+}
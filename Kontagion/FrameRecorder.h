@@ -0,0 +1,66 @@
+#ifndef FRAMERECORDER_H_
+#define FRAMERECORDER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+  // Writes frames out as a numbered sequence of TGA files (prefix00000.tga,
+  // prefix00001.tga, ...) on a thread of its own.  Handing a frame over
+  // only copies its pixels into one of a fixed number of buffers; the
+  // encoding and the file writing happen on the recorder's thread.  When
+  // every buffer is waiting to be written, a frame is either dropped (so
+  // the game never waits on the disk) or waited for, as the caller asks.
+class FrameRecorder
+{
+  public:
+    FrameRecorder(std::string prefix, int maxQueuedFrames);
+
+    ~FrameRecorder();
+
+      // Queue a frame of BGRA pixels, bottom row first (as SoftwareRenderer
+      // and glReadPixels with GL_BGRA give them).  Returns false if it was dropped.
+    bool submit(const std::uint8_t* bgra, int width, int height, bool waitIfFull);
+
+      // Write everything still queued, then stop the thread.  No frames
+      // can be submitted after this.
+    void finish();
+
+      // Frames written, dropped, and how long encoding took.
+    std::string report() const;
+
+  private:
+    struct Frame
+    {
+        int width;
+        int height;
+        std::vector<std::uint32_t> pixels;     // BGRA
+    };
+
+    std::string             m_prefix;
+    std::vector<Frame>      m_frames;       // the buffers, reused over and over
+    std::vector<Frame*>     m_free;         // buffers nobody's using
+    std::deque<Frame*>      m_queued;       // buffers waiting to be written, oldest first
+    mutable std::mutex      m_lock;
+    std::condition_variable m_frameQueued;
+    std::condition_variable m_frameFreed;
+    bool                    m_stopping;
+    std::thread             m_thread;
+      // statistics (guarded by m_lock)
+    long                    m_written;
+    long                    m_dropped;
+    long                    m_failed;
+    std::size_t             m_bytes;
+    double                  m_encodeMs;
+    double                  m_worstEncodeMs;
+
+    void encoderLoop();
+    bool writeTGA(const Frame& frame, const std::string& filename, std::size_t& bytes);
+};
+
+#endif // FRAMERECORDER_H_
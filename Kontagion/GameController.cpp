@@ -5,11 +5,16 @@
 #include "GraphObject.h"
 #include "SoundFX.h"
 #include "SpriteManager.h"
+#include "JobSystem.h"
+#include "AssetPack.h"
 #include <string>
 #include <map>
 #include <utility>
 #include <cstdlib>
 #include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
 using namespace std;
 
 /*
@@ -43,6 +48,24 @@ static const double SCORE_Z = -10;
 
 static const int MS_PER_FRAME = 5;
 
+  // Turbo mode runs up to MAX_TURBO_TICKS ticks per drawn tick; unlimited
+  // turbo runs ticks for UNLIMITED_TURBO_MS and then draws the latest one.
+static const int MAX_TURBO_TICKS = 1024;
+static const int UNLIMITED_TURBO_MS = 30;
+
+  // How many captured frames can wait to be written before more are dropped
+  // (or, headless, before the game waits for the disk).
+static const int CAPTURE_QUEUE_FRAMES = 8;
+
+  // A world too big for the view is shrunk to fit, but its sprites are
+  // never shrunk by more than this, so they don't fall between pixels.
+static const double MIN_SPRITE_SCALE = 1.0 / 16;
+
+  // Samples per second of CPU time taken by -profile.  (Not a round number,
+  // so sampling doesn't fall into step with anything that runs every
+  // millisecond.)
+static const int PROFILE_SAMPLES_PER_SECOND = 997;
+
 struct SpriteInfo
 {
     int         imageID;
@@ -95,13 +118,90 @@ void GameController::initDrawersAndSounds()
     };
 
     string path = m_gw->assetPath();
-    for (const SpriteInfo& d : drawers)
+    chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+
+      // Sprites in the asset pack are ready to use as they are.  The rest
+      // are read from their TGA files, decoded and mipmapped, which doesn't
+      // touch OpenGL, so those are done in parallel; only handing sprites
+      // to OpenGL has to happen here, on the thread that made the window.
+    const int numDrawers = sizeof(drawers) / sizeof(drawers[0]);
+    AssetPack pack;     // (OpenGL and the software renderer copy what they need out of it)
+    bool havePack = pack.open(path + ASSET_PACK_NAME);
+    vector<vector<MipLevelView>> packed(numDrawers);
+    vector<int> toDecode;
+    for (int i = 0; i < numDrawers; i++)
     {
-        if (!m_spriteManager.loadSprite(path + d.tgaFileName, d.imageID, d.frameNum))
+        if (!havePack || !pack.findSprite(drawers[i].tgaFileName, packed[i]))
+            toDecode.push_back(i);
+    }
+    vector<SpriteImage> images(numDrawers);
+    vector<char> decoded(numDrawers);
+    vector<double> decodeMs(numDrawers);
+    vector<double> decodedPixels(numDrawers);
+    int loaderThreads;
+    {
+        JobSystem loaders(max(1, static_cast<int>(thread::hardware_concurrency())) - 1);
+        loaderThreads = loaders.numWorkers() + 1;
+        loaders.parallelFor(static_cast<int>(toDecode.size()), 1, [&](int begin, int end)
+        {
+            for (int j = begin; j < end; j++)
+            {
+                int i = toDecode[j];
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                string file = path + drawers[i].tgaFileName;
+                decoded[i] = (m_softwareRenderer ? m_softwareRenderer->decodeSprite(file, images[i])
+                                                 : m_spriteManager.decodeSprite(file, images[i]));
+                decodeMs[i] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+                if (decoded[i])
+                    decodedPixels[i] = static_cast<double>(images[i].levels[0].width) * images[i].levels[0].height;
+            }
+        });
+    }
+    chrono::steady_clock::time_point uploadStart = chrono::steady_clock::now();
+    for (int i = 0; i < numDrawers; i++)
+    {
+        const SpriteInfo& d = drawers[i];
+        bool loaded;
+        if (!packed[i].empty())
+            loaded = (m_softwareRenderer ? m_softwareRenderer->addSprite(packed[i], d.imageID, d.frameNum)
+                                         : m_spriteManager.addSprite(packed[i], d.imageID, d.frameNum));
+        else
+            loaded = decoded[i]  &&
+                     (m_softwareRenderer ? m_softwareRenderer->addSprite(std::move(images[i]), d.imageID, d.frameNum)
+                                         : m_spriteManager.addSprite(images[i], d.imageID, d.frameNum));
+        if (!loaded)
+        {
+            cout << "Cannot load " << path + d.tgaFileName << endl;
             exit(1);
+        }
     }
+    chrono::steady_clock::time_point loadEnd = chrono::steady_clock::now();
+
+    double decodeWorkMs = 0;
+    double megapixels = 0;
+    for (int i = 0; i < numDrawers; i++)
+    {
+        decodeWorkMs += decodeMs[i];
+        megapixels += decodedPixels[i] / 1e6;
+    }
+    cout << "Loaded " << numDrawers << " sprites in " << chrono::duration<double, milli>(loadEnd - loadStart).count()
+         << " ms (" << numDrawers - toDecode.size() << " from " << ASSET_PACK_NAME << ", "
+         << decodeWorkMs << " ms of decoding " << megapixels << " megapixels";
+      // (the rate is per thread, to compare decoders regardless of how many threads shared the work)
+    if (decodeWorkMs > 0)
+        cout << " at " << megapixels / (decodeWorkMs / 1000) << " MP/s";
+    cout << " on " << loaderThreads << " threads, then "
+         << chrono::duration<double, milli>(loadEnd - uploadStart).count() << " ms uploading); "
+         << "ready " << chrono::duration<double, milli>(loadEnd - m_startTime).count() << " ms after starting" << endl;
+
     for (const auto& s : sounds)
+    {
         m_soundMap[s.first] = s.second;
+        const void* data;
+        size_t size;
+        if (havePack && pack.findFile(s.second, data, size))
+            SoundFX().addClip(path + s.second, data, size);
+    }
 }
 
 static void doSomethingCallback()
@@ -132,14 +232,65 @@ static void timerFuncCallback(int)
 
 void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTitle)
 {
+    m_startTime = chrono::steady_clock::now();
     gw->setController(this);
     m_gw = gw;
+    m_quitRequested = false;
+    m_tickRequested = false;
+    m_tickFinished = false;
+    m_simStopping = false;
+    m_tickStatus = GWSTATUS_CONTINUE_GAME;
+    m_moveInProgress = false;
+    m_turboTicks = 1;
+    m_ticksSinceRate = 0;
+    m_ticksPerSecond = 0;
+    m_rateStart = chrono::steady_clock::now();
     setGameState(welcome);
-    m_lastKeyHit = INVALID_KEY;
     m_singleStep = false;
     m_curIntraFrameTick = 0;
     m_playerWon = false;
 
+    m_windowWidth = WINDOW_WIDTH;
+    m_windowHeight = WINDOW_HEIGHT;
+
+      // "-headless N" plays N ticks with no window, drawing each one with
+      // the software renderer instead of OpenGL, and reports the timings.
+      // "-capture prefix" writes every frame drawn to prefix00000.tga,
+      // prefix00001.tga, and so on.  "-profile filename" samples the tick
+      // and drawing and writes folded stacks for a flame graph to filename
+      // when the game ends (see SamplingProfiler.h).  Any other "-name value" is offered to
+      // the world (see GameWorld::setOption); what it doesn't want is left
+      // for GLUT.
+    int headlessFrames = -1;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "-headless") == 0)
+            headlessFrames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-capture") == 0)
+            m_recorder.reset(new FrameRecorder(argv[++i], CAPTURE_QUEUE_FRAMES));
+        else if (strcmp(argv[i], "-profile") == 0)
+        {
+            m_profiler.reset(new SamplingProfiler);
+            if (!m_profiler->start(argv[++i], PROFILE_SAMPLES_PER_SECOND))
+            {
+                cout << "Cannot profile on this system" << endl;
+                m_profiler.reset();
+            }
+        }
+        else if (argv[i][0] == '-' && m_gw->setOption(argv[i] + 1, argv[i + 1]))
+            i++;
+    }
+    if (headlessFrames >= 0)
+    {
+        m_softwareRenderer.reset(new SoftwareRenderer(WINDOW_WIDTH, WINDOW_HEIGHT));
+        initDrawersAndSounds();
+        runHeadless(headlessFrames);
+        finishCapture();
+        finishProfile();
+        delete m_gw;
+        return;
+    }
+
     glutInit(&argc, argv);
 
     glutInitDisplayMode(GLUT_RGB | GLUT_DEPTH | GLUT_DOUBLE);
@@ -157,6 +308,16 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
 
     glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
     glutMainLoop();
+
+      // The window may have been closed in the middle of a tick.
+    stopSimulation();
+
+      // Report how long key presses waited before the game used them.
+    InputLatencyStats stats = m_input.stats();
+    cout << "Input latency: " << stats.count << " key presses, mean " << stats.meanMicros() / 1000
+         << " ms, worst " << stats.worstMicros / 1000 << " ms, " << stats.dropped << " dropped" << endl;
+    finishCapture();
+    finishProfile();
     delete m_gw;
 }
 
@@ -164,15 +325,18 @@ void GameController::keyboardEvent(unsigned char key, int /* x */, int /* y */)
 {
     switch (key)
     {
-        case 'a': case '4': m_lastKeyHit = KEY_PRESS_LEFT;  break;
-        case 'd': case '6': m_lastKeyHit = KEY_PRESS_RIGHT; break;
-        case 'w': case '8': m_lastKeyHit = KEY_PRESS_UP;    break;
-        case 's': case '2': m_lastKeyHit = KEY_PRESS_DOWN;  break;
-        case 't':           m_lastKeyHit = KEY_PRESS_TAB;   break;
+        case 'a': case '4': m_input.push(KEY_PRESS_LEFT);   break;
+        case 'd': case '6': m_input.push(KEY_PRESS_RIGHT);  break;
+        case 'w': case '8': m_input.push(KEY_PRESS_UP);     break;
+        case 's': case '2': m_input.push(KEY_PRESS_DOWN);   break;
+        case 't':           m_input.push(KEY_PRESS_TAB);    break;
         case 'f':           m_singleStep = true;            break;
         case 'r':           m_singleStep = false;           break;
+        case '+': case '=': changeTurbo(true);              break;
+        case '-': case '_': changeTurbo(false);             break;
+        case 'u':           m_turboTicks = (m_turboTicks == 0 ? 1 : 0); break;
         case 'q': case 'Q': quitGame();                     break;
-        default:            m_lastKeyHit = key;             break;
+        default:            m_input.push(key);              break;
     }
 }
 
@@ -180,25 +344,43 @@ void GameController::specialKeyboardEvent(int key, int /* x */, int /* y */)
 {
     switch (key)
     {
-        case GLUT_KEY_LEFT:  m_lastKeyHit = KEY_PRESS_LEFT;  break;
-        case GLUT_KEY_RIGHT: m_lastKeyHit = KEY_PRESS_RIGHT; break;
-        case GLUT_KEY_UP:    m_lastKeyHit = KEY_PRESS_UP;    break;
-        case GLUT_KEY_DOWN:  m_lastKeyHit = KEY_PRESS_DOWN;  break;
-        default:             m_lastKeyHit = INVALID_KEY;     break;
+        case GLUT_KEY_LEFT:  m_input.push(KEY_PRESS_LEFT);  break;
+        case GLUT_KEY_RIGHT: m_input.push(KEY_PRESS_RIGHT); break;
+        case GLUT_KEY_UP:    m_input.push(KEY_PRESS_UP);    break;
+        case GLUT_KEY_DOWN:  m_input.push(KEY_PRESS_DOWN);  break;
+        default:                                            break;
     }
 }
 
 void GameController::playSound(int soundID)
 {
-    if (soundID == SOUND_NONE)
+    if (m_softwareRenderer)
+        return;     // headless machines have nothing to play sounds on
+
+      // This is usually called from the simulation's thread, so the sound
+      // waits for the main thread's next doSomething.
+    lock_guard<mutex> guard(m_soundLock);
+    m_pendingSounds.push_back(soundID);
+}
+
+void GameController::playPendingSounds()
+{
+    vector<int> sounds;
     {
-        SoundFX().abortClip();
-        return;
+        lock_guard<mutex> guard(m_soundLock);
+        sounds.swap(m_pendingSounds);
+    }
+    for (int soundID : sounds)
+    {
+        if (soundID == SOUND_NONE)
+        {
+            SoundFX().abortClip();
+            continue;
+        }
+        SoundMapType::const_iterator p = m_soundMap.find(soundID);
+        if (p != m_soundMap.end())
+            SoundFX().playClip(m_gw->assetPath() + p->second);
     }
-
-    SoundMapType::const_iterator p = m_soundMap.find(soundID);
-    if (p != m_soundMap.end())
-        SoundFX().playClip(m_gw->assetPath() + p->second);
 }
 
 void GameController::setGameState(GameControllerState s)
@@ -218,11 +400,18 @@ void GameController::setGameStateAfterPrompting(GameControllerState s,
 
 void GameController::quitGame()
 {
-    setGameState(quit);
+      // This can be called while a tick is running on the simulation's
+      // thread, so just note it; doSomething acts on it.
+    m_quitRequested = true;
 }
 
 void GameController::doSomething()
 {
+    if (m_quitRequested)
+        setGameState(quit);
+    if (m_gameState != quit)
+        playPendingSounds();
+
     switch (m_gameState)
     {
         case not_applicable:
@@ -247,29 +436,26 @@ void GameController::doSomething()
                         "Press Enter to quit...");
                 }
                 else
+                {
+                    publishSnapshot();
                     setGameState(makemove);
+                }
             }
             break;
         case makemove:
             m_curIntraFrameTick = ANIMATION_POSITIONS_PER_TICK;
             m_nextStateAfterAnimate = not_applicable;
-            {
-                int status = m_gw->move();
-                if (status == GWSTATUS_PLAYER_DIED)
-                {
-                      // animate one last frame so the player can see what happened
-                    m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
-                }
-                else if (status == GWSTATUS_FINISHED_LEVEL)
-                {
-                    m_gw->advanceToNextLevel();
-                      // animate one last frame so the player can see what happened
-                    m_nextStateAfterAnimate = finishedlevel;
-                }
-            }
+              // Simulate the tick on the simulation's thread, so it runs
+              // while the previous tick's snapshot is being drawn.  Nothing
+              // else may touch the world (or take keys) until finishMove.
+            startMove();
             setGameState(animate);
             break;
         case animate:
+              // On the last frame for this tick, wait for the tick to finish
+              // so that frame shows it.
+            if (m_curIntraFrameTick <= 0)
+                finishMove();
             displayGamePlay();
             if (m_curIntraFrameTick-- <= 0)
             {
@@ -313,14 +499,157 @@ void GameController::doSomething()
             }
             break;
         case quit:
+            stopSimulation();
             SoundFX().abortClip();
             glutLeaveMainLoop();
             break;
     }
 }
 
+int GameController::runTicks()
+{
+      // Normally this is one tick, but in turbo mode it's several (or, in
+      // unlimited turbo mode, as many as fit in UNLIMITED_TURBO_MS), and
+      // only the last is drawn.  A death or a finished level stops it early.
+    SamplingProfiler::Region profiled("tick");
+    int turbo = m_turboTicks;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int status;
+    for (int ticks = 1; ; ticks++)
+    {
+        status = m_gw->move();
+        m_ticksSinceRate++;
+        if (status != GWSTATUS_CONTINUE_GAME)
+            break;
+        if (turbo > 0 ? ticks >= turbo : chrono::steady_clock::now() - start >= chrono::milliseconds(UNLIMITED_TURBO_MS))
+            break;
+    }
+
+      // Work out the throughput about once a second.
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - m_rateStart;
+    if (elapsed.count() >= 1)
+    {
+        m_ticksPerSecond = m_ticksSinceRate / elapsed.count();
+        m_ticksSinceRate = 0;
+        m_rateStart = chrono::steady_clock::now();
+    }
+
+    publishSnapshot();
+    return status;
+}
+
+void GameController::changeTurbo(bool faster)
+{
+    int turbo = m_turboTicks;
+    if (faster)
+        m_turboTicks = (turbo == 0 ? 0 : min(turbo * 2, MAX_TURBO_TICKS));
+    else
+        m_turboTicks = (turbo == 0 ? MAX_TURBO_TICKS : max(turbo / 2, 1));
+}
+
+void GameController::publishSnapshot()
+{
+      // Copy out everything drawing needs, so the next tick can start
+      // changing the GraphObjects while this one is still on screen.
+      // A world bigger (or smaller) than the view is scaled to fit it.
+    RenderSnapshot& snapshot = m_renderBuffer.beginWrite();
+    snapshot.sprites.clear();
+    double scale = VIEW_WIDTH / m_gw->worldSize();
+    double sizeScale = max(scale, MIN_SPRITE_SCALE);
+    snapshot.scale = scale;
+    GraphObject::drawAllObjects(
+        [&](int imageID, int animationNumber, double x, double y, int angle, double size)
+        {
+            SpriteInstance s = { imageID, animationNumber, x * scale, y * scale, angle, size * sizeScale };
+            snapshot.sprites.push_back(s);
+        });
+    snapshot.statText = m_gameStatText;
+    int turbo = m_turboTicks;
+    if (turbo != 1)
+    {
+        ostringstream oss;
+        oss << "  Turbo: " << (turbo == 0 ? string("max") : "x" + to_string(turbo))
+            << " (" << static_cast<int>(m_ticksPerSecond) << " ticks/s)";
+        snapshot.statText += oss.str();
+    }
+    m_renderBuffer.publish();
+}
+
+void GameController::startMove()
+{
+    if (!m_simThread.joinable())
+        m_simThread = thread(&GameController::simulationLoop, this);
+    {
+        lock_guard<mutex> guard(m_simLock);
+        m_tickRequested = true;
+    }
+    m_moveInProgress = true;
+    m_tickRequestedOrStopping.notify_one();
+}
+
+void GameController::simulationLoop()
+{
+    for (;;)
+    {
+        {
+            unique_lock<mutex> guard(m_simLock);
+            m_tickRequestedOrStopping.wait(guard, [this]() { return m_tickRequested || m_simStopping; });
+            if (m_simStopping)
+                return;
+            m_tickRequested = false;
+        }
+        int status = runTicks();
+        {
+            lock_guard<mutex> guard(m_simLock);
+            m_tickStatus = status;
+            m_tickFinished = true;
+        }
+        m_tickFinishedSignal.notify_one();
+    }
+}
+
+void GameController::stopSimulation()
+{
+      // A tick that's already running is finished first; one that was
+      // asked for but not started never runs.
+    {
+        lock_guard<mutex> guard(m_simLock);
+        m_simStopping = true;
+    }
+    m_tickRequestedOrStopping.notify_one();
+    if (m_simThread.joinable())
+        m_simThread.join();
+    m_moveInProgress = false;
+}
+
+void GameController::finishMove()
+{
+    if (!m_moveInProgress)
+        return;
+    int status;
+    {
+        unique_lock<mutex> guard(m_simLock);
+        m_tickFinishedSignal.wait(guard, [this]() { return m_tickFinished; });
+        m_tickFinished = false;
+        status = m_tickStatus;
+    }
+    m_moveInProgress = false;
+    if (status == GWSTATUS_PLAYER_DIED)
+    {
+          // animate one last frame so the player can see what happened
+        m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
+    }
+    else if (status == GWSTATUS_FINISHED_LEVEL)
+    {
+        m_gw->advanceToNextLevel();
+          // animate one last frame so the player can see what happened
+        m_nextStateAfterAnimate = finishedlevel;
+    }
+}
+
 void GameController::displayGamePlay()
 {
+    SamplingProfiler::Region profiled("draw");
     glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
     glLoadIdentity();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -333,22 +662,132 @@ void GameController::displayGamePlay()
 #pragma GCC diagnostic pop
 #endif
 
-    GraphObject::drawAllObjects(
-        [=](int imageID, int animationNumber, double x, double y, int angle, double size)
-        {
-            int frame = animationNumber % m_spriteManager.getNumFrames(imageID);
-            m_spriteManager.plotSprite(imageID, frame, x, y, angle, size);
-        });
+      // Draw the newest finished tick, never the GraphObjects themselves.
+    const RenderSnapshot& snapshot = m_renderBuffer.acquire();
+    for (const SpriteInstance& s : snapshot.sprites)
+    {
+        int frame = s.animationNumber % m_spriteManager.getNumFrames(s.imageID);
+        m_spriteManager.plotSprite(s.imageID, frame, s.x, s.y, s.angle, s.size);
+    }
 
-    drawScoreAndLives(m_gameStatText);
+    drawScoreAndLives(snapshot.statText);
 
-    SpriteManager::drawCircle(VIEW_WIDTH / 2, VIEW_HEIGHT / 2, VIEW_WIDTH / 2 + SPRITE_WIDTH, 100);
+    SpriteManager::drawCircle(VIEW_WIDTH / 2, VIEW_HEIGHT / 2, VIEW_WIDTH / 2 + SPRITE_WIDTH * snapshot.scale, 100);
+
+    if (m_recorder)
+    {
+          // Read the frame back before it's swapped away; the recorder
+          // copies it, so this buffer can be reused straight away.
+        m_captureBuffer.resize(4 * m_windowWidth * m_windowHeight);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_windowWidth, m_windowHeight, GL_BGRA, GL_UNSIGNED_BYTE, m_captureBuffer.data());
+        m_recorder->submit(m_captureBuffer.data(), m_windowWidth, m_windowHeight, false);
+    }
 
     glutSwapBuffers();
 }
 
+void GameController::runHeadless(int frames)
+{
+    int status = m_gw->init();
+    if (status != GWSTATUS_CONTINUE_GAME)
+    {
+        cout << "Cannot start the level (status " << status << ")" << endl;
+        return;
+    }
+    publishSnapshot();
+
+    double tickMs = 0, worstTickMs = 0, drawMs = 0, worstDrawMs = 0;
+    long sprites = 0;
+    int frame = 0;
+    bool inLevel = true;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (frame < frames  &&  !m_quitRequested)
+    {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        status = runTicks();
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        drawSoftwareFrame();
+        if (m_recorder)
+            m_recorder->submit(m_softwareRenderer->pixels(), m_softwareRenderer->width(), m_softwareRenderer->height(), true);
+        chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+        frame++;
+
+        double tick = chrono::duration<double, milli>(t1 - t0).count();
+        double draw = chrono::duration<double, milli>(t2 - t1).count();
+        tickMs += tick;
+        drawMs += draw;
+        worstTickMs = max(worstTickMs, tick);
+        worstDrawMs = max(worstDrawMs, draw);
+        sprites += m_renderBuffer.acquire().sprites.size();
+
+          // Carry on through deaths and levels the way the window would,
+          // minus the prompts.
+        if (status == GWSTATUS_PLAYER_DIED || status == GWSTATUS_FINISHED_LEVEL)
+        {
+            if (status == GWSTATUS_PLAYER_DIED && m_gw->isGameOver())
+                break;
+            if (status == GWSTATUS_FINISHED_LEVEL)
+                m_gw->advanceToNextLevel();
+            m_gw->cleanUp();
+            if (m_gw->init() != GWSTATUS_CONTINUE_GAME)
+            {
+                inLevel = false;
+                break;
+            }
+            publishSnapshot();
+        }
+    }
+    double totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (inLevel)
+        m_gw->cleanUp();
+
+    if (frame == 0)
+        return;
+    cout << "Headless: " << frame << " frames of " << m_softwareRenderer->width() << "x" << m_softwareRenderer->height()
+         << " in " << totalSeconds << " s (" << frame / totalSeconds << " frames/s), "
+         << sprites / frame << " sprites per frame" << endl;
+    cout << "  tick: mean " << tickMs / frame << " ms, worst " << worstTickMs << " ms" << endl;
+    cout << "  draw: mean " << drawMs / frame << " ms, worst " << worstDrawMs << " ms" << endl;
+}
+
+void GameController::drawSoftwareFrame()
+{
+      // The same sprites displayGamePlay draws, minus the text (the stroke
+      // font belongs to GLUT).
+    SamplingProfiler::Region profiled("draw");
+    const RenderSnapshot& snapshot = m_renderBuffer.acquire();
+    m_softwareRenderer->clear();
+    for (const SpriteInstance& s : snapshot.sprites)
+    {
+        int frame = s.animationNumber % m_softwareRenderer->getNumFrames(s.imageID);
+        m_softwareRenderer->plotSprite(s.imageID, frame, s.x, s.y, s.angle, s.size);
+    }
+    m_softwareRenderer->drawCircle(VIEW_WIDTH / 2, VIEW_HEIGHT / 2, VIEW_WIDTH / 2 + SPRITE_WIDTH * snapshot.scale, 100, 204);
+}
+
+void GameController::finishCapture()
+{
+    if (!m_recorder)
+        return;
+    m_recorder->finish();
+    cout << m_recorder->report() << endl;
+    m_recorder.reset();
+}
+
+void GameController::finishProfile()
+{
+    if (!m_profiler)
+        return;
+    m_profiler->stop();
+    cout << m_profiler->report() << endl;
+    m_profiler.reset();
+}
+
 void GameController::reshape (int w, int h)
 {
+    m_windowWidth = w;
+    m_windowHeight = h;
     glViewport (0, 0, (GLsizei) w, (GLsizei) h);
     glMatrixMode (GL_PROJECTION);
     glLoadIdentity ();
@@ -407,9 +846,13 @@ static void drawScoreAndLives(string gameStatText)
     static int RATE = 1;
     static GLfloat rgb[3] =
         { static_cast<GLfloat>(.6), static_cast<GLfloat>(.6), static_cast<GLfloat>(.6) };
+      // Drawing has its own random numbers so it never uses the
+      // simulation's generator from the drawing thread.
+    static std::default_random_engine generator;
+    std::uniform_int_distribution<> flicker(-RATE, RATE);
     for (int k = 0; k < 3; k++)
     {
-        double strength = rgb[k] + randInt(-RATE, RATE) / 100.0;
+        double strength = rgb[k] + flicker(generator) / 100.0;
         if (strength < .6)
             strength = .6;
         else if (strength > 1.0)
@@ -2,8 +2,20 @@
 #define GAMECONTROLLER_H_
 
 #include "SpriteManager.h"
+#include "InputRing.h"
+#include "RenderSnapshot.h"
+#include "SoftwareRenderer.h"
+#include "FrameRecorder.h"
+#include "SamplingProfiler.h"
 #include <string>
 #include <map>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <iostream>
 #include <sstream>
 
@@ -17,15 +29,15 @@ class GameController
   public:
     void run(int argc, char* argv[], GameWorld* gw, std::string windowTitle);
 
+      // Get the oldest key press that hasn't been used yet.  Key presses
+      // queue up, so several hit between ticks aren't lost.
     bool getLastKey(int& value)
     {
-        if (m_lastKeyHit != INVALID_KEY)
-        {
-            value = m_lastKeyHit;
-            m_lastKeyHit = INVALID_KEY;
-            return true;
-        }
-        return false;
+        InputEvent e;
+        if (!m_input.pop(e))
+            return false;
+        value = e.key;
+        return true;
     }
 
     void playSound(int soundID);
@@ -57,7 +69,30 @@ private:
     GameControllerState m_gameState;
     GameControllerState m_nextStateAfterPrompt;
     GameControllerState m_nextStateAfterAnimate;
-    int         m_lastKeyHit;
+    InputRing   m_input;
+    RenderBuffer     m_renderBuffer;
+      // The simulation runs on a thread of its own, one tick (or turbo
+      // batch) at a time when asked, while the previous tick is drawn.  It
+      // hands finished ticks to drawing through m_renderBuffer.
+    std::thread             m_simThread;
+    std::mutex              m_simLock;
+    std::condition_variable m_tickRequestedOrStopping;
+    std::condition_variable m_tickFinishedSignal;
+    bool        m_tickRequested;        // the main thread has asked for a tick the simulation hasn't started
+    bool        m_tickFinished;         // the simulation has finished a tick finishMove hasn't collected
+    bool        m_simStopping;
+    int         m_tickStatus;
+    bool        m_moveInProgress;       // (main thread only) startMove was called and finishMove hasn't been yet
+      // Sounds the world asks for while ticking, played by the main thread
+      // (the sound players aren't safe to use from two threads).
+    std::mutex       m_soundLock;
+    std::vector<int> m_pendingSounds;
+    std::atomic<bool> m_quitRequested;  // quitGame can be called from the simulation's thread
+    std::atomic<int>  m_turboTicks;     // ticks per drawn tick: 1 is normal speed, 0 is as many as fit in a frame
+      // simulation throughput (only touched on the simulation's thread)
+    int         m_ticksSinceRate;
+    double      m_ticksPerSecond;
+    std::chrono::steady_clock::time_point m_rateStart;
     bool        m_singleStep;
     std::string m_gameStatText;
     std::string m_mainMessage;
@@ -68,6 +103,13 @@ private:
     SoundMapType  m_soundMap;
     bool          m_playerWon;
     SpriteManager m_spriteManager;
+    std::unique_ptr<SoftwareRenderer> m_softwareRenderer;  // set when running headless instead of with OpenGL
+    std::unique_ptr<FrameRecorder>    m_recorder;          // set when capturing frames
+    std::unique_ptr<SamplingProfiler> m_profiler;          // set when profiling
+    std::vector<std::uint8_t>         m_captureBuffer;     // frames read back from OpenGL
+    std::chrono::steady_clock::time_point m_startTime;
+    int           m_windowWidth;
+    int           m_windowHeight;
 
     void setGameState(GameControllerState s);
     void setGameStateAfterPrompting(GameControllerState s,
@@ -75,6 +117,18 @@ private:
 
     void initDrawersAndSounds();
     void displayGamePlay();
+    void runHeadless(int frames);
+    void drawSoftwareFrame();
+    void finishCapture();
+    void finishProfile();
+    void publishSnapshot();
+    void startMove();
+    void finishMove();
+    void simulationLoop();
+    void stopSimulation();
+    void playPendingSounds();
+    int runTicks();
+    void changeTurbo(bool faster);
 };
 
 inline GameController& Game()
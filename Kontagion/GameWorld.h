@@ -14,7 +14,7 @@ public:
 
     GameWorld(std::string assetPath)
      : m_lives(START_PLAYER_LIVES), m_score(0), m_level(1),
-       m_controller(nullptr), m_assetPath(assetPath)
+       m_controller(nullptr), m_assetPath(assetPath), m_worldSize(VIEW_WIDTH)
     {
     }
 
@@ -26,6 +26,13 @@ public:
     virtual int move() = 0;
     virtual void cleanUp() = 0;
 
+      // Handle a "-name value" option from the command line; return false
+      // if it isn't one this world understands.
+    virtual bool setOption(std::string /* name */, std::string /* value */)
+    {
+        return false;
+    }
+
     void setGameStatText(std::string text);
 
     bool getKey(int& value);
@@ -65,6 +72,13 @@ public:
     {
         return m_assetPath;
     }
+
+      // Say how many units across the world is (VIEW_WIDTH unless changed).
+      // The framework scales it down or up to fit the view when drawing.
+    void setWorldSize(double size)
+    {
+        m_worldSize = size;
+    }
     
       // The following should be used by only the framework, not the student
 
@@ -82,6 +96,11 @@ public:
     {
         m_controller = controller;
     }
+
+    double worldSize() const
+    {
+        return m_worldSize;
+    }
     
 private:
     int m_lives;
@@ -89,6 +108,7 @@ private:
     int m_level;
     GameController* m_controller;
     std::string     m_assetPath;
+    double          m_worldSize;
 };
 
 #endif // GAMEWORLD_H_
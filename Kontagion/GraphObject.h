@@ -3,14 +3,32 @@
 
 #include "SpriteManager.h"
 #include "GameConstants.h"
+#include "FixedPoint.h"
 
 #include <set>
+#include <vector>
+#include <cstdint>
 #include <cmath>
+#include <functional>
 
 const int ANIMATION_POSITIONS_PER_TICK = 1;
 
 using Direction = int;
 
+  // Something that plots many sprites itself instead of making each one a
+  // GraphObject (e.g., a particle system that keeps its state in arrays).
+class SpriteBatch
+{
+  public:
+    using PlotFunc = std::function<void(int imageID, int animationNumber, double x, double y, int angle, double size)>;
+
+    virtual ~SpriteBatch()
+    {
+    }
+
+    virtual void plotAll(const PlotFunc& plotFunc) const = 0;
+};
+
 class GraphObject
 {
   public:
@@ -21,44 +39,55 @@ class GraphObject
     static const int down = 270;
 
     GraphObject(int imageID, double startX, double startY, Direction dir = 0, int depth = 0, double size = 1.0)
-     : m_imageID(imageID), m_x(startX), m_y(startY), m_destX(startX), m_destY(startY),
-       m_animationNumber(0), m_direction(dir), m_depth(depth), m_size(size)
+     : m_destX(coordFromDouble(startX)), m_destY(coordFromDouble(startY)),
+       m_size(static_cast<float>(size)), m_animationNumber(0),
+       m_imageID(static_cast<int16_t>(imageID)), m_direction(static_cast<int16_t>(dir)),
+       m_depth(static_cast<uint8_t>(depth < NUM_DEPTHS ? depth : 0))
     {
         if (m_size <= 0)
             m_size = 1;
 
-        getGraphObjects(m_depth).insert(this);
+          // Registering appends to a flat array and remembers where, so
+          // unregistering doesn't have to search for it.
+        std::vector<GraphObject*>& objects = getGraphObjects(m_depth);
+        m_registryIndex = static_cast<int>(objects.size());
+        objects.push_back(this);
     }
 
     virtual ~GraphObject()
     {
-        getGraphObjects(m_depth).erase(this);
+          // Move the last object at this depth into our place.
+        std::vector<GraphObject*>& objects = getGraphObjects(m_depth);
+        GraphObject* last = objects.back();
+        objects[m_registryIndex] = last;
+        last->m_registryIndex = m_registryIndex;
+        objects.pop_back();
     }
 
     double getX() const
     {
           // If already moved but not yet animated, use new location anyway.
-        return m_destX;
+        return coordToDouble(m_destX);
     }
 
     double getY() const
     {
           // If already moved but not yet animated, use new location anyway.
-        return m_destY;
+        return coordToDouble(m_destY);
     }
 
     virtual void moveTo(double x, double y)
     {
-        m_destX = x;
-        m_destY = y;
+        m_destX = coordFromDouble(x);
+        m_destY = coordFromDouble(y);
         increaseAnimationNumber();
     }
 
     virtual void moveAngle(Direction angle, int units = 1)
     {
-    	const double PI = 4 * atan(1);
-    	double newX = (getX() + units * cos(angle*1.0 / 360 * 2 * PI));
-    	double newY = (getY() + units * sin(angle*1.0 / 360 * 2 * PI));
+    	double newX;
+    	double newY;
+    	getPositionInThisDirection(angle, units, newX, newY);
 
     	moveTo(newX, newY);
     	increaseAnimationNumber();
@@ -66,9 +95,15 @@ class GraphObject
 
     virtual void getPositionInThisDirection(Direction angle, int units, double &dx, double &dy)
     {
+#ifdef KONTAGION_FIXED_POINT
+          // Integer math on the table's sines and cosines, so every build lands on the same spot.
+        dx = fixedToDouble(m_destX + units * fixedCos(angle));
+        dy = fixedToDouble(m_destY + units * fixedSin(angle));
+#else
     	const double PI = 4 * atan(1);
     	dx = (getX() + units * cos(angle*1.0 / 360 * 2 * PI));
     	dy = (getY() + units * sin(angle*1.0 / 360 * 2 * PI));
+#endif
     }
 
     void moveForward(int units = 1)
@@ -86,12 +121,12 @@ class GraphObject
         while (d < 0)
             d += 360;
 
-        m_direction = d % 360;
+        m_direction = static_cast<int16_t>(d % 360);
     }
 
     void setSize(double size)
     {
-        m_size = size;
+        m_size = static_cast<float>(size);
     }
 
     double getSize() const
@@ -112,13 +147,23 @@ class GraphObject
         for (int depth = NUM_DEPTHS - 1; depth >= 0; depth--)
         {
             for (GraphObject* go : getGraphObjects(depth))
-            {
-                go->animate();
-                plotFunc(go->m_imageID, go->m_animationNumber, go->m_x, go->m_y, go->m_direction, go->m_size);
-            }
+                plotFunc(go->m_imageID, go->m_animationNumber, coordToDouble(go->m_destX), coordToDouble(go->m_destY), go->m_direction, go->m_size);
+            for (SpriteBatch* batch : getSpriteBatches(depth))
+                batch->plotAll(plotFunc);
         }
     }
 
+      // Sprite batches are drawn along with the GraphObjects at their depth
+    static void addSpriteBatch(SpriteBatch* batch, int depth)
+    {
+        getSpriteBatches(depth).insert(batch);
+    }
+
+    static void removeSpriteBatch(SpriteBatch* batch, int depth)
+    {
+        getSpriteBatches(depth).erase(batch);
+    }
+
       // Prevent copying or assigning GraphObjects
     GraphObject(const GraphObject&) = delete;
     GraphObject& operator=(const GraphObject&) = delete;
@@ -126,42 +171,32 @@ class GraphObject
   private:
 
     static const int NUM_DEPTHS = 4;
-    int     m_imageID;
-    double  m_x;
-    double  m_y;
-    double  m_destX;
-    double  m_destY;
-    int     m_animationNumber;
-    Direction   m_direction;
-    int     m_depth;
-    double  m_size;
 
-    void animate()
-    {
-        m_x = m_destX;
-        m_y = m_destY;
-        //moveALittle(m_x, m_destX);
-        //moveALittle(m_y, m_destY);
-    }
+      // Objects are drawn right where they are (there's no animating between
+      // positions), so only one position is kept.  The rest is only needed
+      // for drawing, so it's stored as narrowly as it comfortably fits.
+    Coord   m_destX;
+    Coord   m_destY;
+    float   m_size;
+    int     m_animationNumber;
+    int     m_registryIndex;    // where this object is in getGraphObjects(m_depth)
+    int16_t m_imageID;
+    int16_t m_direction;
+    uint8_t m_depth;
 
-    void moveALittle(double& from, double& to)
+    static std::vector<GraphObject*>& getGraphObjects(int depth)
     {
-        static const double DISTANCE = 1.0/ANIMATION_POSITIONS_PER_TICK;
-        if (to - from >= DISTANCE)
-            from += DISTANCE;
-        else if (from - to >= DISTANCE)
-            from -= DISTANCE;
-        else
-            from = to;
+        static std::vector<GraphObject*> graphObjects[NUM_DEPTHS];
+        return graphObjects[depth];
     }
 
-    static std::set<GraphObject*>& getGraphObjects(int depth)
+    static std::set<SpriteBatch*>& getSpriteBatches(int depth)
     {
-        static std::set<GraphObject*> graphObjects[NUM_DEPTHS];
+        static std::set<SpriteBatch*> spriteBatches[NUM_DEPTHS];
         if (depth < NUM_DEPTHS)
-            return graphObjects[depth];
+            return spriteBatches[depth];
         else
-            return graphObjects[0];     // empty;
+            return spriteBatches[0];
     }
 };
 
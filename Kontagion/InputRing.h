@@ -0,0 +1,96 @@
+#ifndef INPUTRING_H_
+#define INPUTRING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+
+  // One key press, and when it happened.
+struct InputEvent
+{
+    int key;
+    std::chrono::steady_clock::time_point when;
+};
+
+  // How long key presses waited between being hit and being used.
+struct InputLatencyStats
+{
+    long   count = 0;           // key presses used so far
+    double totalMicros = 0;
+    double worstMicros = 0;
+    long   dropped = 0;         // key presses lost because the ring was full
+
+    double meanMicros() const
+    {
+        return count > 0 ? totalMicros / count : 0;
+    }
+};
+
+  // A fixed-size ring of timestamped key presses with exactly one producer
+  // (the keyboard callbacks) and one consumer (whoever asks for the next
+  // key).  Neither side takes a lock: only the producer writes m_tail and
+  // only the consumer writes m_head, and each publishes its index with a
+  // release store that the other side reads with an acquire load.  Presses
+  // that arrive while the ring is full are dropped (and counted), so a held
+  // key can never build up more than CAPACITY ticks of lag.
+class InputRing
+{
+  public:
+    static const std::size_t CAPACITY = 16;     // must be a power of two
+
+    InputRing()
+     : m_head(0), m_tail(0), m_dropped(0)
+    {
+    }
+
+      // Producer side: add a key press, stamped with the current time.
+    bool push(int key)
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == CAPACITY)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        InputEvent& e = m_events[tail & (CAPACITY - 1)];
+        e.key = key;
+        e.when = std::chrono::steady_clock::now();
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+      // Consumer side: take the oldest key press, if there is one, and
+      // record how long it waited.
+    bool pop(InputEvent& e)
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        e = m_events[head & (CAPACITY - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+
+        std::chrono::duration<double, std::micro> waited = std::chrono::steady_clock::now() - e.when;
+        m_stats.count++;
+        m_stats.totalMicros += waited.count();
+        m_stats.worstMicros = std::max(m_stats.worstMicros, waited.count());
+        return true;
+    }
+
+      // Consumer side.
+    InputLatencyStats stats() const
+    {
+        InputLatencyStats s = m_stats;
+        s.dropped = m_dropped.load(std::memory_order_relaxed);
+        return s;
+    }
+
+  private:
+    InputEvent m_events[CAPACITY];
+    std::atomic<std::size_t> m_head;    // next event to pop; written only by the consumer
+    std::atomic<std::size_t> m_tail;    // next free spot; written only by the producer
+    std::atomic<long> m_dropped;
+    InputLatencyStats m_stats;          // touched only by the consumer
+};
+
+#endif // INPUTRING_H_
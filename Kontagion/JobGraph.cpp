@@ -0,0 +1,80 @@
+#include "JobGraph.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+
+/**********************************************************************************/
+/*                       JOBGRAPH CLASS IMPLEMENTATION                            */
+/**********************************************************************************/
+int JobGraph::add(const string& name, function<void()> f, const vector<int>& dependsOn)
+{
+	int id = m_nodes.size();
+	Node* n = new Node;
+	n->name = name;
+	n->f = f;
+	n->dependsOn = dependsOn;
+	n->waitingOn = 0;
+	m_nodes.push_back(unique_ptr<Node>(n));
+	for (size_t i = 0; i < dependsOn.size(); i++)
+		m_nodes[dependsOn[i]]->dependents.push_back(id);
+	return id;
+}
+
+void JobGraph::run(JobSystem& pool)
+{
+	m_unfinished = m_nodes.size();
+	for (size_t i = 0; i < m_nodes.size(); i++)
+		m_nodes[i]->waitingOn = m_nodes[i]->dependsOn.size();
+	// start every job that doesn't depend on anything; the rest are started by the jobs they wait on
+	for (size_t i = 0; i < m_nodes.size(); i++)
+	{
+		if (m_nodes[i]->dependsOn.empty())
+		{
+			int id = i;
+			pool.submit([this, &pool, id]() { execute(pool, id); });
+		}
+	}
+	// help out until everything's done
+	pool.helpUntilDone(m_unfinished);
+}
+
+void JobGraph::execute(JobSystem& pool, int id)
+{
+	Node& n = *m_nodes[id];
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	n.f();
+	chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+	n.runs++;
+	n.lastMicros = elapsed.count();
+	n.totalMicros += n.lastMicros;
+	n.worstMicros = max(n.worstMicros, n.lastMicros);
+	n.lastThread = pool.currentThread();
+	// whichever dependency finishes last starts each dependent
+	for (size_t i = 0; i < n.dependents.size(); i++)
+	{
+		int next = n.dependents[i];
+		if (--m_nodes[next]->waitingOn == 0)
+			pool.submit([this, &pool, next]() { execute(pool, next); });
+	}
+	pool.jobDone(m_unfinished);
+}
+
+string JobGraph::report() const
+{
+	ostringstream oss;
+	oss << "  " << left << setw(20) << "job" << setw(28) << "after" << right
+		<< setw(10) << "last us" << setw(10) << "mean us" << setw(10) << "worst us" << setw(8) << "thread" << endl;
+	for (size_t i = 0; i < m_nodes.size(); i++)
+	{
+		const Node& n = *m_nodes[i];
+		string after;
+		for (size_t j = 0; j < n.dependsOn.size(); j++)
+			after += (j > 0 ? ", " : "") + m_nodes[n.dependsOn[j]]->name;
+		oss << "  " << left << setw(20) << n.name << setw(28) << (after.empty() ? "-" : after) << right << fixed << setprecision(1)
+			<< setw(10) << n.lastMicros << setw(10) << (n.runs > 0 ? n.totalMicros / n.runs : 0) << setw(10) << n.worstMicros
+			<< setw(8) << n.lastThread << endl;
+	}
+	return oss.str();
+}
@@ -0,0 +1,52 @@
+#ifndef JOBGRAPH_INCLUDED
+#define JOBGRAPH_INCLUDED
+
+#include "JobSystem.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A set of named jobs and which ones have to finish before each can start.
+// Running the graph runs every job once, starting each as soon as the jobs
+// it depends on are done, so jobs that don't depend on each other can run
+// at the same time on different threads.  The graph is built once and run
+// over and over; it keeps track of how long each job takes.
+class JobGraph
+{
+public:
+	// Add a job that runs f after every job in dependsOn is done, and
+	// return its id.  Jobs can only depend on jobs added before them.
+	int add(const std::string& name, std::function<void()> f, const std::vector<int>& dependsOn = std::vector<int>());
+
+	// Run every job, using the pool (and the calling thread), and return
+	// when they're all done.
+	void run(JobSystem& pool);
+
+	// A table of the jobs, what each depends on, and how long it took last
+	// time, on average, and at worst, and on which thread it last ran.
+	std::string report() const;
+
+private:
+	struct Node
+	{
+		std::string name;
+		std::function<void()> f;
+		std::vector<int> dependsOn;
+		std::vector<int> dependents;
+		std::atomic<int> waitingOn;		// dependencies not yet done in the current run
+		// timings (only written by the thread running the job)
+		long runs = 0;
+		double lastMicros = 0;
+		double totalMicros = 0;
+		double worstMicros = 0;
+		int lastThread = 0;
+	};
+	std::vector<std::unique_ptr<Node>> m_nodes;
+	std::atomic<int> m_unfinished;
+
+	void execute(JobSystem& pool, int id);
+};
+
+#endif // JOBGRAPH_INCLUDED
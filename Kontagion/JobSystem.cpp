@@ -0,0 +1,171 @@
+#include "JobSystem.h"
+#include <algorithm>
+using namespace std;
+
+// the pool the running thread works for, and which of that pool's queues is its own;
+// there can be more than one pool, so the index only means something for t_pool
+static thread_local const JobSystem* t_pool = nullptr;
+static thread_local int t_thread = 0;
+
+/**********************************************************************************/
+/*                      JOBSYSTEM CLASS IMPLEMENTATION                            */
+/**********************************************************************************/
+JobSystem::JobSystem(int numWorkers)
+{
+	m_queued = 0;
+	m_nextQueue = 0;
+	m_stopping = false;
+	// queue 0 is shared by threads outside the pool; each worker gets one of its own
+	for (int i = 0; i <= numWorkers; i++)
+		m_queues.push_back(unique_ptr<Queue>(new Queue));
+	for (int i = 1; i <= numWorkers; i++)
+		m_threads.push_back(thread(&JobSystem::workerLoop, this, i));
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		lock_guard<mutex> guard(m_sleepLock);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (size_t i = 0; i < m_threads.size(); i++)
+		m_threads[i].join();
+}
+
+int JobSystem::numWorkers() const
+{
+	return m_threads.size();
+}
+
+void JobSystem::submit(Job job)
+{
+	// workers push onto their own queue; everyone else spreads jobs over the workers' queues
+	int q = currentThread();
+	if (q == 0 && !m_threads.empty())
+		q = 1 + m_nextQueue++ % m_threads.size();
+	{
+		lock_guard<mutex> guard(m_queues[q]->lock);
+		m_queues[q]->jobs.push_back(move(job));
+	}
+	{
+		lock_guard<mutex> guard(m_sleepLock);
+		m_queued++;
+	}
+	m_wake.notify_one();
+}
+
+bool JobSystem::runOne()
+{
+	Job job;
+	if (!takeJob(currentThread(), job))
+		return false;
+	job();
+	return true;
+}
+
+void JobSystem::parallelFor(int n, int grain, const function<void(int, int)>& f)
+{
+	if (n <= grain || m_threads.empty())
+	{
+		f(0, n);
+		return;
+	}
+	// one piece per thread at most, but never smaller than grain
+	int pieces = min((int)m_threads.size() + 1, (n + grain - 1) / grain);
+	int size = (n + pieces - 1) / pieces;
+	atomic<int> remaining(pieces - 1);
+	for (int begin = size; begin < n; begin += size)
+	{
+		int end = min(n, begin + size);
+		submit([this, &f, &remaining, begin, end]()
+		{
+			f(begin, end);
+			jobDone(remaining);
+		});
+	}
+	// do the first piece here, then help with whatever's queued until the rest are done
+	f(0, min(n, size));
+	helpUntilDone(remaining);
+}
+
+void JobSystem::helpUntilDone(atomic<int>& remaining)
+{
+	while (remaining > 0)
+	{
+		if (runOne())
+			continue;
+		// the jobs left are running on other threads: sleep until one finishes the lot or queues another
+		unique_lock<mutex> guard(m_sleepLock);
+		m_wake.wait(guard, [this, &remaining]() { return remaining == 0 || m_queued > 0; });
+	}
+}
+
+void JobSystem::jobDone(atomic<int>& remaining)
+{
+	if (--remaining > 0)
+		return;
+	// taking the lock means the waiting thread is either still checking the count or already asleep, so it can't miss this
+	{
+		lock_guard<mutex> guard(m_sleepLock);
+	}
+	m_wake.notify_all();
+}
+
+int JobSystem::currentThread() const
+{
+	// a worker of some other pool is an outside thread as far as this one is concerned
+	return t_pool == this ? t_thread : 0;
+}
+
+bool JobSystem::takeJob(int self, Job& job)
+{
+	if (m_queued == 0)
+		return false;
+	// newest job from our own queue first (it's most likely still in cache)...
+	{
+		Queue& own = *m_queues[self];
+		lock_guard<mutex> guard(own.lock);
+		if (!own.jobs.empty())
+		{
+			job = move(own.jobs.back());
+			own.jobs.pop_back();
+			m_queued--;
+			return true;
+		}
+	}
+	// ...then steal the oldest job from someone else
+	for (size_t i = 1; i < m_queues.size(); i++)
+	{
+		Queue& other = *m_queues[(self + i) % m_queues.size()];
+		lock_guard<mutex> guard(other.lock);
+		if (!other.jobs.empty())
+		{
+			job = move(other.jobs.front());
+			other.jobs.pop_front();
+			m_queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::workerLoop(int self)
+{
+	t_pool = this;
+	t_thread = self;
+	for (;;)
+	{
+		Job job;
+		if (takeJob(self, job))
+		{
+			job();
+			continue;
+		}
+		// nothing to do: sleep until something is submitted
+		unique_lock<mutex> guard(m_sleepLock);
+		m_wake.wait(guard, [this]() { return m_stopping || m_queued > 0; });
+		if (m_stopping)
+			return;
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef JOBSYSTEM_INCLUDED
+#define JOBSYSTEM_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of worker threads that run small jobs.  Every worker has its own
+// queue: it takes the newest job from its own queue, and when that's empty
+// it steals the oldest job from someone else's, so work spreads out without
+// one shared queue everyone fights over.  Threads that aren't workers (such
+// as the one calling StudentWorld::move) can help out too, with runOne.
+class JobSystem
+{
+public:
+	typedef std::function<void()> Job;
+
+	// Start numWorkers worker threads (0 is fine; then every job runs on
+	// whichever thread calls runOne or parallelFor).
+	explicit JobSystem(int numWorkers);
+	~JobSystem();
+
+	// How many worker threads are there?
+	int numWorkers() const;
+
+	// Queue a job to be run by some thread.
+	void submit(Job job);
+
+	// Run one queued job on the calling thread, if there is one.  Return
+	// false if every queue was empty.
+	bool runOne();
+
+	// Call f(begin, end) over 0 through n - 1, split into pieces of at least
+	// grain items, spread over the pool; return when every piece is done.
+	// If n is no bigger than grain, f is just called right here.
+	void parallelFor(int n, int grain, const std::function<void(int, int)>& f);
+
+	// Run queued jobs on the calling thread until remaining gets to 0,
+	// sleeping whenever there's nothing to run.  The jobs being waited for
+	// must count remaining down with jobDone, not by hand, so the waiting
+	// thread is woken when it gets to 0.
+	void helpUntilDone(std::atomic<int>& remaining);
+	void jobDone(std::atomic<int>& remaining);
+
+	// Which of this pool's threads is this?  0 for threads outside the pool
+	// (including the workers of any other pool), and 1 through numWorkers()
+	// for its own workers.
+	int currentThread() const;
+
+private:
+	struct Queue
+	{
+		std::mutex lock;
+		std::deque<Job> jobs;
+	};
+	std::vector<std::unique_ptr<Queue>> m_queues;	// m_queues[i] belongs to thread i
+	std::vector<std::thread> m_threads;
+	std::atomic<int> m_queued;
+	std::atomic<int> m_nextQueue;					// where outside threads put jobs next
+	std::mutex m_sleepLock;
+	std::condition_variable m_wake;					// something was queued, a count got to 0, or the pool is stopping
+	bool m_stopping;
+
+	bool takeJob(int self, Job& job);
+	void workerLoop(int self);
+};
+
+#endif // JOBSYSTEM_INCLUDED
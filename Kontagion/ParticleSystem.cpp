@@ -0,0 +1,122 @@
+#include "ParticleSystem.h"
+#include "StudentWorld.h"
+#include <cmath>
+using namespace std;
+
+/**********************************************************************************/
+/*                    PARTICLESYSTEM CLASS IMPLEMENTATION                         */
+/**********************************************************************************/
+ParticleSystem::ParticleSystem(StudentWorld* w, int depth)
+{
+	m_world = w;
+	m_depth = depth;
+	GraphObject::addSpriteBatch(this, m_depth);
+}
+
+ParticleSystem::~ParticleSystem()
+{
+	GraphObject::removeSpriteBatch(this, m_depth);
+}
+
+void ParticleSystem::launch(int imageID, double x, double y, int dir, int range, int damage)
+{
+	m_x.push_back(coordFromDouble(x));
+	m_y.push_back(coordFromDouble(y));
+	// the step is computed the same way GraphObject::moveAngle does it, so particles follow the same path a moving actor would
+#ifdef KONTAGION_FIXED_POINT
+	m_stepX.push_back(SPRITE_WIDTH * fixedCos(dir));
+	m_stepY.push_back(SPRITE_WIDTH * fixedSin(dir));
+#else
+	const double PI = 4 * atan(1);
+	m_stepX.push_back(SPRITE_WIDTH * cos(dir * 1.0 / 360 * 2 * PI));
+	m_stepY.push_back(SPRITE_WIDTH * sin(dir * 1.0 / 360 * 2 * PI));
+#endif
+	m_range.push_back(range);
+	m_damage.push_back(damage);
+	m_hit.push_back(0);
+	m_imageID.push_back(imageID);
+	m_dir.push_back(dir);
+	m_animationNumber.push_back(0);
+}
+
+void ParticleSystem::update()
+{
+	size_t n = m_x.size();
+	// first, check each particle's path for something to damage (this needs the world, so it's one particle at a time)
+	for (size_t i = 0; i < n; i++)
+	{
+		// a particle on its last step dies before it gets to the next position, so only where it is now counts
+		int reach = (m_range[i] > SPRITE_WIDTH ? 1 : 0);
+		m_hit[i] = m_world->damageOneActor(coordToDouble(m_x[i]), coordToDouble(m_y[i]), coordToDouble(m_x[i] + reach * m_stepX[i]),
+											  coordToDouble(m_y[i] + reach * m_stepY[i]), m_damage[i], m_imageID[i] == IID_FLAME ? CAUSE_FLAME : CAUSE_SPRAY);
+	}
+	// then move every particle forward in one branch-free pass over the arrays
+	// (particles that hit something get removed below, so moving them too doesn't matter)
+	for (size_t i = 0; i < n; i++)
+	{
+		m_x[i] += m_stepX[i];
+		m_y[i] += m_stepY[i];
+		m_range[i] -= SPRITE_WIDTH;
+		// moving an actor with moveAngle bumps its animation number twice, so do the same to get the same frames
+		m_animationNumber[i] += 2;
+	}
+	// finally, remove particles that hit something or have travelled their limit
+	size_t i = 0;
+	while (i < m_x.size())
+	{
+		if (m_hit[i] || m_range[i] <= 0)
+			removeAt(i);
+		else
+			i++;
+	}
+}
+
+void ParticleSystem::clear()
+{
+	m_x.clear();
+	m_y.clear();
+	m_stepX.clear();
+	m_stepY.clear();
+	m_range.clear();
+	m_damage.clear();
+	m_hit.clear();
+	m_imageID.clear();
+	m_dir.clear();
+	m_animationNumber.clear();
+}
+
+int ParticleSystem::size() const
+{
+	return m_x.size();
+}
+
+void ParticleSystem::plotAll(const PlotFunc& plotFunc) const
+{
+	for (size_t i = 0; i < m_x.size(); i++)
+		plotFunc(m_imageID[i], m_animationNumber[i], coordToDouble(m_x[i]), coordToDouble(m_y[i]), m_dir[i], 1.0);
+}
+
+void ParticleSystem::removeAt(size_t i)
+{
+	size_t last = m_x.size() - 1;
+	m_x[i] = m_x[last];
+	m_y[i] = m_y[last];
+	m_stepX[i] = m_stepX[last];
+	m_stepY[i] = m_stepY[last];
+	m_range[i] = m_range[last];
+	m_damage[i] = m_damage[last];
+	m_hit[i] = m_hit[last];
+	m_imageID[i] = m_imageID[last];
+	m_dir[i] = m_dir[last];
+	m_animationNumber[i] = m_animationNumber[last];
+	m_x.pop_back();
+	m_y.pop_back();
+	m_stepX.pop_back();
+	m_stepY.pop_back();
+	m_range.pop_back();
+	m_damage.pop_back();
+	m_hit.pop_back();
+	m_imageID.pop_back();
+	m_dir.pop_back();
+	m_animationNumber.pop_back();
+}
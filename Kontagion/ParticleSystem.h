@@ -0,0 +1,55 @@
+#ifndef PARTICLESYSTEM_INCLUDED
+#define PARTICLESYSTEM_INCLUDED
+
+#include "GraphObject.h"
+#include <vector>
+
+class StudentWorld;
+
+// Sprays and flames.  Instead of each one being its own Actor, their state
+// is kept in parallel arrays (one entry per particle) so that a whole burst
+// can be moved in one tight loop.  Each particle travels SPRITE_WIDTH pixels
+// per tick, damages the first actor along its path, and disappears when it
+// hits something or runs out of range.
+class ParticleSystem : public SpriteBatch
+{
+public:
+	ParticleSystem(StudentWorld* w, int depth);
+	virtual ~ParticleSystem();
+
+	// Launch a particle from (x, y) in direction dir that can travel range
+	// pixels and does the indicated amount of damage.
+	void launch(int imageID, double x, double y, int dir, int range, int damage);
+
+	// Move every particle one step, damaging the first actor along each path.
+	void update();
+
+	// Remove every particle.
+	void clear();
+
+	// How many particles are in flight?
+	int size() const;
+
+	virtual void plotAll(const PlotFunc& plotFunc) const;
+
+private:
+	StudentWorld* m_world;
+	int m_depth;
+
+	// one entry per particle (positions are kept the way GraphObject keeps them)
+	std::vector<Coord> m_x;
+	std::vector<Coord> m_y;
+	std::vector<Coord> m_stepX;
+	std::vector<Coord> m_stepY;
+	std::vector<int> m_range;
+	std::vector<int> m_damage;
+	std::vector<int> m_hit;
+	std::vector<int> m_imageID;
+	std::vector<int> m_dir;
+	std::vector<int> m_animationNumber;
+
+	// remove particle i by moving the last particle into its place
+	void removeAt(size_t i);
+};
+
+#endif // PARTICLESYSTEM_INCLUDED
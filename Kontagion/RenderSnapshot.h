@@ -0,0 +1,74 @@
+#ifndef RENDERSNAPSHOT_H_
+#define RENDERSNAPSHOT_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+  // Everything needed to draw one sprite.
+struct SpriteInstance
+{
+    int    imageID;
+    int    animationNumber;
+    double x;
+    double y;
+    int    angle;
+    double size;
+};
+
+  // Everything needed to draw one tick of the game, copied out of the
+  // GraphObjects once the tick is over, so drawing never has to look at
+  // objects the simulation might be changing.  Sprites are in drawing order.
+struct RenderSnapshot
+{
+    std::vector<SpriteInstance> sprites;
+    std::string statText;
+    double scale = 1;       // view units per world unit (sprites are already scaled)
+};
+
+  // Three snapshots passed between one writer (the simulation) and one
+  // reader (the drawing code) without locks.  The writer always has a
+  // buffer of its own to fill, the reader always has one of its own to
+  // draw, and the third holds the newest finished snapshot; publishing and
+  // acquiring just swap buffers with that third one.  So the writer never
+  // waits for drawing, and the reader always gets the newest whole tick.
+class RenderBuffer
+{
+  public:
+    RenderBuffer()
+     : m_writeIndex(0), m_readIndex(1), m_latest(2)
+    {
+    }
+
+      // Writer: the snapshot to fill in.
+    RenderSnapshot& beginWrite()
+    {
+        return m_buffers[m_writeIndex];
+    }
+
+      // Writer: make the snapshot just filled in the newest one.
+    void publish()
+    {
+        m_writeIndex = m_latest.exchange(m_writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+      // Reader: the newest published snapshot.  It stays put until the next
+      // call to acquire.
+    const RenderSnapshot& acquire()
+    {
+        if (m_latest.load(std::memory_order_relaxed) & FRESH)
+            m_readIndex = m_latest.exchange(m_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return m_buffers[m_readIndex];
+    }
+
+  private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;     // set in m_latest when it holds a snapshot the reader hasn't seen
+
+    RenderSnapshot   m_buffers[3];
+    int              m_writeIndex;  // only the writer touches this
+    int              m_readIndex;   // only the reader touches this
+    std::atomic<int> m_latest;
+};
+
+#endif // RENDERSNAPSHOT_H_
@@ -0,0 +1,266 @@
+#include "SamplingProfiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+using namespace std;
+
+#ifndef _MSC_VER
+#include <cerrno>
+#include <csignal>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#endif
+
+enum { EMPTY, FILLING, READY };
+
+  // Frames at the top of every sample that belong to the signal handling
+  // itself: sample() and the handler.  (The kernel's return trampoline sits
+  // between them and the interrupted code.)
+static const int HANDLER_FRAMES = 3;
+static const int MAX_PROBES = 32;       // table slots tried before a stack is dropped
+
+static SamplingProfiler* s_current = nullptr;
+static std::atomic<int> s_activeRegions(0);
+static thread_local const char* t_region = nullptr;
+
+static std::uint64_t hashStack(const char* region, void* const* frames, int depth)
+{
+    std::uint64_t h = 1469598103934665603ull ^ reinterpret_cast<std::uintptr_t>(region);
+    for (int i = 0; i < depth; i++)
+        h = (h ^ reinterpret_cast<std::uintptr_t>(frames[i])) * 1099511628211ull;
+    return h ^ (h >> 29);
+}
+
+SamplingProfiler::SamplingProfiler()
+ : m_samples(0), m_dropped(0), m_written(0), m_running(false)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+SamplingProfiler::Region::Region(const char* name)
+ : m_previous(t_region)
+{
+    t_region = name;
+    s_activeRegions.fetch_add(1, std::memory_order_relaxed);
+}
+
+SamplingProfiler::Region::~Region()
+{
+    s_activeRegions.fetch_sub(1, std::memory_order_relaxed);
+    t_region = m_previous;
+}
+
+#ifdef _MSC_VER
+
+bool SamplingProfiler::start(const string& /* filename */, int /* hz */)
+{
+    return false;
+}
+
+void SamplingProfiler::stop()
+{
+}
+
+void SamplingProfiler::sample()
+{
+}
+
+#else
+
+static void onSignal(int, siginfo_t*, void*)
+{
+    int savedErrno = errno;
+    SamplingProfiler::sample();
+    errno = savedErrno;
+}
+
+bool SamplingProfiler::start(const string& filename, int hz)
+{
+    if (m_running || s_current != nullptr || hz <= 0)
+        return false;
+    m_table.reset(new Stack[TABLE_SIZE]);
+    for (int i = 0; i < TABLE_SIZE; i++)
+    {
+        m_table[i].state.store(EMPTY, std::memory_order_relaxed);
+        m_table[i].count.store(0, std::memory_order_relaxed);
+    }
+    m_filename = filename;
+    m_samples = 0;
+    m_dropped = 0;
+    m_written = 0;
+
+      // The first backtrace loads the unwinder, which allocates; get that
+      // over with here rather than in the signal handler.
+    void* warmUp[4];
+    backtrace(warmUp, 4);
+
+    s_current = this;
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = onSignal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = max(1000000 / hz, 1);
+    timer.it_value = timer.it_interval;
+    if (sigaction(SIGPROF, &action, nullptr) != 0 || setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+    {
+        s_current = nullptr;
+        return false;
+    }
+    m_running = true;
+    return true;
+}
+
+void SamplingProfiler::stop()
+{
+    if (!m_running)
+        return;
+    struct itimerval off;
+    memset(&off, 0, sizeof(off));
+    setitimer(ITIMER_PROF, &off, nullptr);
+      // A signal already on its way is ignored rather than killing the game.
+    signal(SIGPROF, SIG_IGN);
+    s_current = nullptr;
+    m_running = false;
+    write();
+}
+
+void SamplingProfiler::sample()
+{
+    SamplingProfiler* p = s_current;
+    if (p == nullptr)
+        return;
+    const char* region = t_region;
+    if (region == nullptr)
+    {
+        if (s_activeRegions.load(std::memory_order_relaxed) == 0)
+            return;
+        region = "other threads";
+    }
+    void* frames[MAX_DEPTH + HANDLER_FRAMES];
+    int depth = backtrace(frames, MAX_DEPTH + HANDLER_FRAMES);
+    if (depth <= HANDLER_FRAMES)
+        return;
+    p->record(region, frames + HANDLER_FRAMES, depth - HANDLER_FRAMES);
+}
+
+#endif
+
+void SamplingProfiler::record(const char* region, void* const* frames, int depth)
+{
+      // Everything here has to be safe in a signal handler, possibly
+      // running on several threads at once: no locks and no allocation.
+    m_samples.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t h = hashStack(region, frames, depth);
+    for (int probe = 0; probe < MAX_PROBES; probe++)
+    {
+        Stack& s = m_table[(h + probe) & (TABLE_SIZE - 1)];
+        std::uint32_t state = s.state.load(std::memory_order_acquire);
+        if (state == EMPTY)
+        {
+            if (!s.state.compare_exchange_strong(state, FILLING, std::memory_order_acquire))
+                continue;       // another thread took it; it may be a copy of this stack, but
+                                // duplicates are merged when the stacks are written
+            s.depth = depth;
+            s.region = region;
+            copy(frames, frames + depth, s.frames);
+            s.count.store(1, std::memory_order_relaxed);
+            s.state.store(READY, std::memory_order_release);
+            return;
+        }
+        if (state == READY && s.region == region && s.depth == static_cast<std::uint32_t>(depth)
+            && equal(frames, frames + depth, s.frames))
+        {
+            s.count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+#ifndef _MSC_VER
+  // A readable name for the function containing address.
+static string frameName(void* address, map<void*, string>& cache)
+{
+    auto cached = cache.find(address);
+    if (cached != cache.end())
+        return cached->second;
+    string name;
+    Dl_info info;
+    bool found = dladdr(address, &info) != 0;
+    if (found && info.dli_sname != nullptr)
+    {
+        int status;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        name = (status == 0 && demangled != nullptr ? demangled : info.dli_sname);
+        free(demangled);
+    }
+    else if (found && info.dli_fname != nullptr)
+    {
+          // no symbol; the module and offset are enough for addr2line
+        string module = info.dli_fname;
+        module = module.substr(module.find_last_of('/') + 1);
+        ostringstream oss;
+        oss << module << "+0x" << hex << reinterpret_cast<std::uintptr_t>(address) - reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+        name = oss.str();
+    }
+    else
+    {
+        ostringstream oss;
+        oss << address;
+        name = oss.str();
+    }
+      // ';' separates frames in the folded format
+    replace(name.begin(), name.end(), ';', ':');
+    cache[address] = name;
+    return name;
+}
+#endif
+
+void SamplingProfiler::write()
+{
+#ifndef _MSC_VER
+    map<void*, string> names;
+    map<string, std::uint64_t> folded;
+    for (int i = 0; i < TABLE_SIZE; i++)
+    {
+        const Stack& s = m_table[i];
+        if (s.state.load(std::memory_order_acquire) != READY)
+            continue;
+        string line = s.region;
+        for (int k = s.depth - 1; k >= 0; k--)
+        {
+              // return addresses point just past the call; step back into it
+              // so the right function (and line, for addr2line) is named
+            void* address = (k == 0 ? s.frames[k] : static_cast<char*>(s.frames[k]) - 1);
+            line += ';' + frameName(address, names);
+        }
+        folded[line] += s.count.load(std::memory_order_relaxed);
+    }
+    ofstream out(m_filename);
+    for (auto it = folded.begin(); it != folded.end(); it++)
+        out << it->first << ' ' << it->second << '\n';
+    m_written = folded.size();
+#endif
+}
+
+string SamplingProfiler::report() const
+{
+    ostringstream oss;
+    oss << "Profile: " << m_samples << " samples";
+    if (m_dropped > 0)
+        oss << " (" << m_dropped << " not kept: too many distinct stacks)";
+    oss << ", " << m_written << " distinct stacks written to " << m_filename;
+    return oss.str();
+}
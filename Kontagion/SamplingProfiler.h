@@ -0,0 +1,96 @@
+#ifndef SAMPLINGPROFILER_H_
+#define SAMPLINGPROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+  // A sampling profiler built into the game, so there's no need to attach
+  // an outside one to the GLUT window.  While it runs, a SIGPROF timer
+  // interrupts whichever thread is using the CPU every so often (counting
+  // CPU time, not wall time), and the signal handler records that thread's
+  // call stack.  (Many kernels deliver SIGPROF at most once per scheduler
+  // tick, often 250 times a second, whatever rate is asked for.)
+  //
+  // Only the tick and drawing are sampled: code marks what a thread is
+  // doing with a Region, and samples taken while no Region is active
+  // anywhere are ignored.  Samples from threads outside any Region while
+  // one is active elsewhere (the tick's worker threads, say) are put under
+  // "other threads".
+  //
+  // The handler can't allocate, so stacks are counted in a hash table made
+  // up front; stacks seen again just bump a count.  When the profiler is
+  // stopped, the stacks are written as "folded" lines, one per distinct
+  // stack with the outermost function first, which flamegraph.pl and
+  // speedscope read directly:
+  //
+  //     tick;main;GameController::runTicks();StudentWorld::move() 312
+  //
+  // Functions are named from the dynamic symbol table, so link with
+  // -rdynamic to get names for everything; frames without a name are
+  // written as module+offset, for addr2line.  Only POSIX systems have
+  // SIGPROF; elsewhere start just returns false.
+class SamplingProfiler
+{
+  public:
+    static const int MAX_DEPTH = 48;            // deeper stacks are cut off at the outermost end
+    static const int TABLE_SIZE = 8192;         // distinct stacks kept; must be a power of two
+
+    SamplingProfiler();
+    ~SamplingProfiler();
+
+      // Start sampling hz times per second of CPU time, writing to filename
+      // when stopped.  Only one profiler can run at a time.
+    bool start(const std::string& filename, int hz);
+
+      // Stop sampling and write the folded stacks.
+    void stop();
+
+      // How many samples were taken, how many distinct stacks, and where
+      // they went.
+    std::string report() const;
+
+      // Marks the calling thread as doing something worth profiling, until
+      // the Region is destroyed.  The name (which must be a string literal
+      // or otherwise outlive the profiler) becomes the root of its stacks.
+    class Region
+    {
+      public:
+        explicit Region(const char* name);
+        ~Region();
+      private:
+        const char* m_previous;
+        Region(const Region&);
+        Region& operator=(const Region&);
+    };
+
+      // Take a sample of the calling thread, if it's being profiled.  Only
+      // the signal handler calls this.
+    static void sample();
+
+  private:
+    struct Stack
+    {
+        std::atomic<std::uint32_t> state;       // EMPTY, FILLING or READY
+        std::uint32_t              depth;
+        const char*                region;
+        void*                      frames[MAX_DEPTH];   // innermost first
+        std::atomic<std::uint64_t> count;
+    };
+
+    std::unique_ptr<Stack[]> m_table;
+    std::string        m_filename;
+    std::atomic<long>  m_samples;
+    std::atomic<long>  m_dropped;       // stacks that didn't fit in the table
+    long               m_written;       // distinct stacks written
+    bool               m_running;
+
+    void record(const char* region, void* const* frames, int depth);
+    void write();
+
+    SamplingProfiler(const SamplingProfiler&);
+    SamplingProfiler& operator=(const SamplingProfiler&);
+};
+
+#endif // SAMPLINGPROFILER_H_
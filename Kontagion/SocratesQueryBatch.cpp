@@ -0,0 +1,121 @@
+#include "SocratesQueryBatch.h"
+#include "Actor.h"
+#include <cmath>
+using namespace std;
+
+// atan2 in degrees without any branches, so it can be used inside a vectorized loop:
+// fold the angle into the first octant, approximate atan there with a polynomial
+// (Abramowitz & Stegun 4.4.49, error under 0.00001 radians), then unfold it
+static inline float atan2Degrees(float y, float x)
+{
+	float ax = fabsf(x);
+	float ay = fabsf(y);
+	float largest = ax > ay ? ax : ay;
+	float smallest = ax > ay ? ay : ax;
+	float z = smallest / (largest + 1e-30f);
+	float z2 = z * z;
+	float r = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+	r = ay > ax ? 1.57079633f - r : r;
+	r = x < 0 ? 3.14159265f - r : r;
+	r = y < 0 ? -r : r;
+	return r * 57.2957795f;
+}
+
+/**********************************************************************************/
+/*                  SOCRATESQUERYBATCH CLASS IMPLEMENTATION                       */
+/**********************************************************************************/
+void SocratesQueryBatch::resize(int n)
+{
+	m_x.resize(n);
+	m_y.resize(n);
+	m_dx.resize(n);
+	m_dy.resize(n);
+	m_overlapDx.resize(n);
+	m_overlapDy.resize(n);
+	m_distance.resize(n);
+	m_angle.resize(n);
+	m_overlaps.resize(n);
+}
+
+void SocratesQueryBatch::run(const vector<Actor*>& actors, double socratesX, double socratesY, int begin, int end)
+{
+	// overlapping is checked against Socrates's position rounded toward zero, as Actor::isOverlapping does
+	int overlapX = (int)socratesX;
+	int overlapY = (int)socratesY;
+	// gather the positions into flat arrays
+	for (int i = begin; i < end; i++)
+	{
+		m_x[i] = actors[i]->getX();
+		m_y[i] = actors[i]->getY();
+		m_dx[i] = (float)(socratesX - m_x[i]);
+		m_dy[i] = (float)(socratesY - m_y[i]);
+		m_overlapDx[i] = (float)(overlapX - m_x[i]);
+		m_overlapDy[i] = (float)(overlapY - m_y[i]);
+	}
+#ifdef KONTAGION_FIXED_POINT
+	// the answers have to match the single queries bit for bit, so use the same integer math they do
+	Fixed fixedX = fixedFromDouble(socratesX);
+	Fixed fixedY = fixedFromDouble(socratesY);
+	const int64_t fixedOverlapLimit = (int64_t)SPRITE_WIDTH * FIXED_ONE * SPRITE_WIDTH * FIXED_ONE;
+	for (int i = begin; i < end; i++)
+	{
+		Fixed x = fixedFromDouble(m_x[i]);
+		Fixed y = fixedFromDouble(m_y[i]);
+		m_distance[i] = fixedDistance(x, y, fixedX, fixedY);
+		m_overlaps[i] = fixedDistanceSquared(x, y, overlapX * FIXED_ONE, overlapY * FIXED_ONE) <= fixedOverlapLimit;
+		m_angle[i] = (float)fixedAngleDegrees(fixedY - y, fixedX - x);
+	}
+#else
+	// then work out all the answers; none of these loops branch, so they vectorize
+	const float overlapLimit = SPRITE_WIDTH * SPRITE_WIDTH;
+	for (int i = begin; i < end; i++)
+		m_distance[i] = sqrtf(m_dx[i] * m_dx[i] + m_dy[i] * m_dy[i]);
+	for (int i = begin; i < end; i++)
+		m_overlaps[i] = (m_overlapDx[i] * m_overlapDx[i] + m_overlapDy[i] * m_overlapDy[i]) <= overlapLimit;
+	for (int i = begin; i < end; i++)
+		m_angle[i] = atan2Degrees(m_dy[i], m_dx[i]);
+#endif
+}
+
+void SocratesQueryBatch::clear()
+{
+	m_x.clear();
+	m_y.clear();
+	m_dx.clear();
+	m_dy.clear();
+	m_overlapDx.clear();
+	m_overlapDy.clear();
+	m_distance.clear();
+	m_angle.clear();
+	m_overlaps.clear();
+}
+
+int SocratesQueryBatch::size() const
+{
+	return m_x.size();
+}
+
+bool SocratesQueryBatch::isFor(int i, double x, double y) const
+{
+	return i >= 0 && i < (int)m_x.size() && m_x[i] == x && m_y[i] == y;
+}
+
+double SocratesQueryBatch::distance(int i) const
+{
+#ifdef KONTAGION_FIXED_POINT
+	return fixedToDouble(m_distance[i]);
+#else
+	return m_distance[i];
+#endif
+}
+
+bool SocratesQueryBatch::overlaps(int i) const
+{
+	return m_overlaps[i] != 0;
+}
+
+int SocratesQueryBatch::angle(int i) const
+{
+	// round toward zero, like assigning the result of atan2 to an int does
+	return (int)m_angle[i];
+}
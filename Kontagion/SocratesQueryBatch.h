@@ -0,0 +1,75 @@
+#ifndef SOCRATESQUERYBATCH_INCLUDED
+#define SOCRATESQUERYBATCH_INCLUDED
+
+#include "FixedPoint.h"
+#include <vector>
+
+class Actor;
+
+// Answers "how far away is Socrates, am I touching him, and which way is he?"
+// for a whole list of actors at once.  Positions are copied into flat float
+// arrays and the answers are worked out in simple branch-free loops over
+// those arrays, which the compiler can turn into SIMD code.
+//
+// Accuracy compared with doing each query on its own in double precision
+// (Actor::getDistance, atan2):
+//   - a float has 24 bits of precision, so distances are off by up to about
+//     one part in 10 million: within 0.0001 pixels in the default 256 pixel
+//     dish, and within 0.003 pixels across the largest one (-dishRadius
+//     8192, where distances reach about 23000 pixels).  A comparison against
+//     a whole-number distance (e.g., "within 72 pixels") only comes out
+//     differently if the true distance is that close to the limit;
+//   - angles come from a polynomial approximation of atan2 that is within
+//     0.001 degrees at any dish size, so after rounding toward zero to a
+//     whole degree (as the single queries do) they are the same or off by
+//     one, and only off by one when the true angle is within about 0.001
+//     degrees of a whole degree.
+// When built with KONTAGION_FIXED_POINT, the answers are worked out with the
+// same integer math as the single queries instead, and match them exactly.
+class SocratesQueryBatch
+{
+public:
+	// Make room for answers for n actors.
+	void resize(int n);
+
+	// Work out the answers for actors[begin] through actors[end - 1], with
+	// Socrates at (socratesX, socratesY).  Different ranges can be worked
+	// out at the same time on different threads.
+	void run(const std::vector<Actor*>& actors, double socratesX, double socratesY, int begin, int end);
+
+	// Forget all the answers.
+	void clear();
+
+	// How many actors are there answers for?
+	int size() const;
+
+	// Are the answers at index i for an actor at (x, y)?  (They aren't if
+	// the actor has moved since the batch was run.)
+	bool isFor(int i, double x, double y) const;
+
+	// The answers for the actor at index i.
+	double distance(int i) const;
+	bool overlaps(int i) const;
+	int angle(int i) const;
+
+private:
+	// the positions the answers are for
+	std::vector<double> m_x;
+	std::vector<double> m_y;
+	// the same positions, relative to Socrates, as floats for the batch loops
+	std::vector<float> m_dx;
+	std::vector<float> m_dy;
+	std::vector<float> m_overlapDx;
+	std::vector<float> m_overlapDy;
+	// answers
+#ifdef KONTAGION_FIXED_POINT
+	// a 16.16 distance can need more than a float's 24 bits in a big dish
+	std::vector<Fixed> m_distance;
+#else
+	std::vector<float> m_distance;
+#endif
+	std::vector<float> m_angle;
+	std::vector<int> m_overlaps;
+};
+
+#endif // SOCRATESQUERYBATCH_INCLUDED
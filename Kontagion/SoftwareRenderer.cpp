@@ -0,0 +1,263 @@
+#include "SoftwareRenderer.h"
+#include "SpriteManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+using namespace std;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RENDERER_SSE2
+#endif
+
+  // Must match the gluPerspective call in GameController::reshape.
+static const double FIELD_OF_VIEW_Y = 45;
+
+  // Sprites are numbered the same way SpriteManager numbers them.
+static const int MAX_IMAGES = 1000;
+static const int MAX_FRAMES_PER_SPRITE = 100;
+
+static int getSpriteID(int imageID, int frame)
+{
+    if (imageID >= MAX_IMAGES || frame >= MAX_FRAMES_PER_SPRITE)
+        return -1;
+    return imageID * MAX_FRAMES_PER_SPRITE + frame;
+}
+
+  // v / 255, rounded, for v up to 255 * 255 (the most a blended channel
+  // can add up to).
+static inline unsigned int div255(unsigned int v)
+{
+    v += 128;
+    return (v + (v >> 8)) >> 8;
+}
+
+  // dst = src * srcAlpha + dst * (1 - srcAlpha) for count BGRA pixels, in
+  // every channel, like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+static void blendSpan(uint8_t* dst, const uint8_t* src, int count)
+{
+    int i = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+      // Four pixels at a time: widen each channel to 16 bits, multiply by
+      // the pixel's alpha (copied into all four of its channels) and by
+      // 255 minus that, and narrow back down.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    for ( ; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + 4 * i));
+        __m128i result[2];
+        for (int h = 0; h < 2; h++)
+        {
+            __m128i s16 = (h == 0 ? _mm_unpacklo_epi8(s, zero) : _mm_unpackhi_epi8(s, zero));
+            __m128i d16 = (h == 0 ? _mm_unpacklo_epi8(d, zero) : _mm_unpackhi_epi8(d, zero));
+            __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            __m128i v = _mm_add_epi16(_mm_mullo_epi16(s16, a), _mm_mullo_epi16(d16, _mm_sub_epi16(full, a)));
+            v = _mm_add_epi16(v, half);
+            result[h] = _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), _mm_packus_epi16(result[0], result[1]));
+    }
+#endif
+    for ( ; i < count; i++)
+    {
+        unsigned int a = src[4 * i + 3];
+        for (int c = 0; c < 4; c++)
+            dst[4 * i + c] = static_cast<uint8_t>(div255(src[4 * i + c] * a + dst[4 * i + c] * (255 - a)));
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+ : m_width(width), m_height(height), m_pixels(4 * width * height), m_span(4 * width)
+{
+    clear();
+}
+
+bool SoftwareRenderer::loadSprite(string filename_tga, int imageID, int frameNum)
+{
+    SpriteImage image;
+    return decodeSprite(filename_tga, image)  &&  addSprite(std::move(image), imageID, frameNum);
+}
+
+bool SoftwareRenderer::decodeSprite(string filename_tga, SpriteImage& image) const
+{
+      // No need for power of two sizes here.
+    return loadSpriteImage(filename_tga, false, true, image);
+}
+
+bool SoftwareRenderer::addSprite(SpriteImage&& image, int imageID, int frameNum)
+{
+    int spriteID = getSpriteID(imageID, frameNum);
+    if (spriteID == -1)
+        return false;
+
+    m_frameCountPerSprite[imageID]++;   // keep track of how many frames per sprite we loaded
+    m_textures[spriteID] = std::move(image);
+    return true;
+}
+
+bool SoftwareRenderer::addSprite(const vector<MipLevelView>& levels, int imageID, int frameNum)
+{
+    SpriteImage image;
+    for (const MipLevelView& view : levels)
+    {
+        MipLevel level;
+        level.width = view.width;
+        level.height = view.height;
+        level.texels.assign(view.texels, view.texels + 4 * view.width * view.height);
+        image.levels.push_back(std::move(level));
+    }
+    return addSprite(std::move(image), imageID, frameNum);
+}
+
+int SoftwareRenderer::getNumFrames(int imageID) const
+{
+    auto it = m_frameCountPerSprite.find(imageID);
+    if (it == m_frameCountPerSprite.end())
+        return 0;
+
+    return it->second;
+}
+
+void SoftwareRenderer::clear()
+{
+    for (size_t i = 0; i < m_pixels.size(); i += 4)
+    {
+        m_pixels[i] = m_pixels[i + 1] = m_pixels[i + 2] = 0;
+        m_pixels[i + 3] = 255;
+    }
+}
+
+bool SoftwareRenderer::plotSprite(int imageID, int frame, double x, double y, int angleDegrees, double size)
+{
+    auto it = m_textures.find(getSpriteID(imageID, frame));
+    if (it == m_textures.end())
+        return false;
+    const vector<MipLevel>& texture = it->second.levels;
+
+      // Corners in pixels, in the order that gets texture coordinates
+      // (0,0), (1,0), (1,1), (0,1).
+    double gx, gy, gz;
+    SpriteManager::convertToGlutCoords(x, y, gx, gy, gz);
+    double rx[4], ry[4];
+    SpriteManager::getSpriteCorners(size, angleDegrees, rx, ry);
+    double px[4], py[4];
+    for (int k = 0; k < 4; k++)
+        toPixel(gx + rx[k], gy + ry[k], px[k], py[k]);
+
+      // The quad is a parallelogram, so a pixel at p has texture coordinates
+      // u, v where p = corner0 + u * edgeU + v * edgeV.  Invert that.
+    double edgeUx = px[1] - px[0], edgeUy = py[1] - py[0];
+    double edgeVx = px[3] - px[0], edgeVy = py[3] - py[0];
+    double det = edgeUx * edgeVy - edgeUy * edgeVx;
+    if (det == 0)
+        return true;
+    double dUdx = edgeVy / det, dUdy = -edgeVx / det;
+    double dVdx = -edgeUy / det, dVdy = edgeUx / det;
+
+      // Use the mipmap whose texels come closest to one per pixel.
+    double texelsPerPixel = max(texture[0].width / hypot(edgeUx, edgeUy), texture[0].height / hypot(edgeVx, edgeVy));
+    int level = 0;
+    if (texelsPerPixel > 1)
+        level = min(static_cast<int>(texture.size()) - 1, static_cast<int>(floor(log2(texelsPerPixel) + .5)));
+    const MipLevel& mip = texture[level];
+
+    int yFirst = max(0, static_cast<int>(floor(*min_element(py, py + 4))));
+    int yLast = min(m_height - 1, static_cast<int>(ceil(*max_element(py, py + 4))));
+    for (int row = yFirst; row <= yLast; row++)
+    {
+          // Along this row, u and v are linear in x; find the x range where
+          // both are in [0, 1).
+        double cy = row + .5 - py[0];
+        double u0 = -px[0] * dUdx + cy * dUdy;
+        double v0 = -px[0] * dVdx + cy * dVdy;
+        double lo = 0, hi = m_width;
+        bool empty = false;
+        const double slope[2] = { dUdx, dVdx };
+        const double start[2] = { u0, v0 };
+        for (int k = 0; k < 2; k++)
+        {
+            if (slope[k] == 0)
+            {
+                if (start[k] < 0 || start[k] >= 1)
+                    empty = true;
+                continue;
+            }
+            double t0 = -start[k] / slope[k];
+            double t1 = (1 - start[k]) / slope[k];
+            lo = max(lo, min(t0, t1));
+            hi = min(hi, max(t0, t1));
+        }
+        if (empty)
+            continue;
+          // pixel centers x + .5 in [lo, hi)
+        int xFirst = max(0, static_cast<int>(ceil(lo - .5)));
+        int xEnd = min(m_width, static_cast<int>(ceil(hi - .5)));
+        if (xFirst >= xEnd)
+            continue;
+
+          // Gather the row's texels, then blend them in one go.
+        uint8_t* span = m_span.data();
+        for (int col = xFirst; col < xEnd; col++)
+        {
+            double cx = col + .5;
+            int tx = min(mip.width - 1, max(0, static_cast<int>((u0 + cx * dUdx) * mip.width)));
+            int ty = min(mip.height - 1, max(0, static_cast<int>((v0 + cx * dVdx) * mip.height)));
+            memcpy(span + 4 * (col - xFirst), &mip.texels[4 * (ty * mip.width + tx)], 4);
+        }
+        blendSpan(&m_pixels[4 * (row * m_width + xFirst)], span, xEnd - xFirst);
+    }
+    return true;
+}
+
+void SoftwareRenderer::drawCircle(float cx, float cy, float r, int num_segments, uint8_t grey)
+{
+    double prevX = 0, prevY = 0, firstX = 0, firstY = 0;
+    for (int ii = 0; ii < num_segments; ii++)
+    {
+        float theta = 2.0f * 3.1415926f * float(ii) / float(num_segments);
+        double gx, gy, gz;
+        SpriteManager::convertToGlutCoords(r * cosf(theta) + cx, r * sinf(theta) + cy, gx, gy, gz);
+        double px, py;
+        toPixel(gx, gy, px, py);
+        if (ii == 0)
+        {
+            firstX = px;
+            firstY = py;
+        }
+        else
+            drawLine(prevX, prevY, px, py, grey);
+        prevX = px;
+        prevY = py;
+    }
+    drawLine(prevX, prevY, firstX, firstY, grey);
+}
+
+void SoftwareRenderer::toPixel(double x, double y, double& px, double& py) const
+{
+      // Everything is drawn at the same depth, so the perspective
+      // projection comes down to a scale about the center of the frame.
+    double gx, gy, gz;
+    SpriteManager::convertToGlutCoords(0, 0, gx, gy, gz);
+    double halfHeight = -gz * tan(FIELD_OF_VIEW_Y / 2 * 4 * atan(1.0) / 180);
+    double halfWidth = halfHeight * m_width / m_height;
+    px = (x / halfWidth + 1) * m_width / 2;
+    py = (y / halfHeight + 1) * m_height / 2;
+}
+
+void SoftwareRenderer::drawLine(double x0, double y0, double x1, double y1, uint8_t grey)
+{
+    int steps = max(1, static_cast<int>(ceil(max(fabs(x1 - x0), fabs(y1 - y0)))));
+    for (int i = 0; i <= steps; i++)
+    {
+        int x = static_cast<int>(floor(x0 + (x1 - x0) * i / steps));
+        int y = static_cast<int>(floor(y0 + (y1 - y0) * i / steps));
+        if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+            continue;
+        uint8_t* p = &m_pixels[4 * (y * m_width + x)];
+        p[0] = p[1] = p[2] = grey;
+        p[3] = 255;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef SOFTWARERENDERER_H_
+#define SOFTWARERENDERER_H_
+
+#include "SpriteImage.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+  // Draws sprites the way SpriteManager does (same placement, rotation,
+  // and reflection, through the same perspective as the window), but on
+  // the CPU into a BGRA framebuffer in memory, so frames can be made
+  // without a display or an OpenGL context.  Rows are stored bottom row
+  // first, like glReadPixels and TGA files.
+class SoftwareRenderer
+{
+  public:
+    SoftwareRenderer(int width, int height);
+
+    bool loadSprite(std::string filename_tga, int imageID, int frameNum);
+
+      // loadSprite in two steps: decodeSprite can be called on any thread
+      // (at the same time as other calls to it), addSprite can't.
+    bool decodeSprite(std::string filename_tga, SpriteImage& image) const;
+    bool addSprite(SpriteImage&& image, int imageID, int frameNum);
+    bool addSprite(const std::vector<MipLevelView>& levels, int imageID, int frameNum);
+
+    int getNumFrames(int imageID) const;
+
+      // Fill the framebuffer with opaque black.
+    void clear();
+
+      // Alpha blend one sprite into the framebuffer, sampling the mipmap
+      // closest to its size on screen.
+    bool plotSprite(int imageID, int frame, double x, double y, int angleDegrees, double size);
+
+      // Draw a circle outline of num_segments straight lines, like
+      // SpriteManager::drawCircle.
+    void drawCircle(float cx, float cy, float r, int num_segments, std::uint8_t grey);
+
+    int width() const  { return m_width; }
+    int height() const { return m_height; }
+    const std::uint8_t* pixels() const { return m_pixels.data(); }
+
+  private:
+    std::map<int, SpriteImage> m_textures;
+    std::map<int, int>         m_frameCountPerSprite;
+    int                        m_width;
+    int                        m_height;
+    std::vector<std::uint8_t> m_pixels;
+    std::vector<std::uint8_t> m_span;       // one row of sampled texels, ready to blend
+
+    void toPixel(double x, double y, double& px, double& py) const;
+    void drawLine(double x0, double y0, double x1, double y1, std::uint8_t grey);
+};
+
+#endif // SOFTWARERENDERER_H_
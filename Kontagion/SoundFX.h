@@ -2,6 +2,7 @@
 #define SOUNDFX_H_
 
 #include <string>
+#include <cstddef>
 
 #if defined(_MSC_VER)
 
@@ -19,6 +20,13 @@ class SoundFXController
             m_engine->play2D(soundFile.c_str(), false);
     }
 
+      // Make playClip(soundFile) play these bytes instead of reading the file.
+    void addClip(std::string soundFile, const void* data, std::size_t size)
+    {
+        if (m_engine != nullptr)
+            m_engine->addSoundSourceFromMemory(const_cast<void*>(data), static_cast<irrklang::ik_s32>(size), soundFile.c_str());
+    }
+
     void abortClip()
     {
         if (m_engine != nullptr)
@@ -71,6 +79,9 @@ class SoundFXController
         abortClip();  // stop anything currently playing
         pidValid = (posix_spawn(&pid, argv[0], nullptr, nullptr, argv, nullptr) == 0);
     }
+
+      // afplay needs a file, so clips always come from the loose files.
+    void addClip(std::string, const void*, std::size_t) {}
     
     void abortClip()
     {
@@ -92,6 +103,7 @@ class SoundFXController
 {
   public:
     void playClip(std::string) {}
+    void addClip(std::string, const void*, std::size_t) {}
     void abortClip() {}
     static SoundFXController& getInstance();
 };
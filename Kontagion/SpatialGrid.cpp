@@ -0,0 +1,175 @@
+#include "SpatialGrid.h"
+#include "Actor.h"
+#include "FixedPoint.h"
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+
+/**********************************************************************************/
+/*                     SPATIALGRID CLASS IMPLEMENTATION                           */
+/**********************************************************************************/
+SpatialGrid::SpatialGrid(double width, double height, double cellSize)
+{
+	m_cellSize = cellSize;
+	m_cols = max(1, (int)ceil(width / cellSize));
+	m_rows = max(1, (int)ceil(height / cellSize));
+	m_cells.resize(m_cols * m_rows);
+}
+
+void SpatialGrid::insert(Actor* a)
+{
+	m_cells[rowOf(a->getY()) * m_cols + columnOf(a->getX())].push_back(a);
+}
+
+bool SpatialGrid::remove(Actor* a, double x, double y)
+{
+	vector<Actor*>& cell = m_cells[rowOf(y) * m_cols + columnOf(x)];
+	for (size_t i = 0; i < cell.size(); i++)
+	{
+		if (cell[i] == a)
+		{
+			// order within a cell doesn't matter, so swap with the last actor instead of shifting
+			cell[i] = cell.back();
+			cell.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+void SpatialGrid::update(Actor* a, double oldX, double oldY)
+{
+	// if the actor is still in the same cell, there's nothing to do
+	if (columnOf(oldX) == columnOf(a->getX()) && rowOf(oldY) == rowOf(a->getY()))
+		return;
+	if (remove(a, oldX, oldY))
+		insert(a);
+}
+
+void SpatialGrid::clear()
+{
+	for (auto it = m_cells.begin(); it != m_cells.end(); it++)
+		it->clear();
+}
+
+double SpatialGrid::distanceSquaredToSegment(double px, double py, double x0, double y0, double x1, double y1)
+{
+#ifdef KONTAGION_FIXED_POINT
+	// the same projection in 1/65536ths, with the fraction along the segment in 16.16
+	// (the point is never far from a segment this short, so every product fits in 64 bits)
+	int64_t dx = (int64_t)fixedFromDouble(x1) - fixedFromDouble(x0);
+	int64_t dy = (int64_t)fixedFromDouble(y1) - fixedFromDouble(y0);
+	int64_t fx = (int64_t)fixedFromDouble(px) - fixedFromDouble(x0);
+	int64_t fy = (int64_t)fixedFromDouble(py) - fixedFromDouble(y0);
+	int64_t lengthSquared = dx * dx + dy * dy;
+	int64_t t = 0;
+	if (lengthSquared > 0)
+		t = max((int64_t)0, min((int64_t)FIXED_ONE, (fx * dx + fy * dy) * FIXED_ONE / lengthSquared));
+	int64_t ex = t * dx / FIXED_ONE - fx;
+	int64_t ey = t * dy / FIXED_ONE - fy;
+	return (ex * ex + ey * ey) / ((double)FIXED_ONE * FIXED_ONE);
+#else
+	double dx = x1 - x0;
+	double dy = y1 - y0;
+	double lengthSquared = dx * dx + dy * dy;
+	// project the point onto the segment, clamping to the endpoints
+	double t = 0;
+	if (lengthSquared > 0)
+		t = max(0.0, min(1.0, ((px - x0) * dx + (py - y0) * dy) / lengthSquared));
+	double ex = x0 + t * dx - px;
+	double ey = y0 + t * dy - py;
+	return ex * ex + ey * ey;
+#endif
+}
+
+bool SpatialGrid::firstContactAlongSegment(double cx, double cy, double radius, double x0, double y0, double x1, double y1, double& t)
+{
+#ifdef KONTAGION_FIXED_POINT
+	// the same equation in whole 1/256ths of a pixel, which keeps the discriminant within 64 bits
+	const int64_t UNIT = FIXED_ONE / 256;
+	int64_t dx = ((int64_t)fixedFromDouble(x1) - fixedFromDouble(x0)) / UNIT;
+	int64_t dy = ((int64_t)fixedFromDouble(y1) - fixedFromDouble(y0)) / UNIT;
+	int64_t fx = ((int64_t)fixedFromDouble(x0) - fixedFromDouble(cx)) / UNIT;
+	int64_t fy = ((int64_t)fixedFromDouble(y0) - fixedFromDouble(cy)) / UNIT;
+	int64_t r = (int64_t)fixedFromDouble(radius) / UNIT;
+	// too far away to be touched anywhere along the segment (this also bounds the products below)
+	int64_t reach = r + llabs(dx) + llabs(dy);
+	if (llabs(fx) > reach || llabs(fy) > reach)
+		return false;
+	// already within radius at the start of the segment
+	int64_t c = fx * fx + fy * fy - r * r;
+	if (c <= 0)
+	{
+		t = 0;
+		return true;
+	}
+	// otherwise t = (-halfB - sqrt(halfB^2 - a * c)) / a, with the root rounded down
+	int64_t a = dx * dx + dy * dy;
+	int64_t halfB = fx * dx + fy * dy;
+	int64_t discriminant = halfB * halfB - a * c;
+	if (a == 0 || discriminant < 0)
+		return false;
+	int64_t numerator = -halfB - (int64_t)integerSqrt(discriminant);
+	if (numerator < 0 || numerator > a)
+		return false;
+	t = fixedToDouble((Fixed)(numerator * FIXED_ONE / a));
+	return true;
+#else
+	double dx = x1 - x0;
+	double dy = y1 - y0;
+	double fx = x0 - cx;
+	double fy = y0 - cy;
+	// already within radius at the start of the segment
+	double c = fx * fx + fy * fy - radius * radius;
+	if (c <= 0)
+	{
+		t = 0;
+		return true;
+	}
+	// otherwise, solve |(x0, y0) + t * (dx, dy) - (cx, cy)| = radius for the smaller t
+	double a = dx * dx + dy * dy;
+	double b = 2 * (fx * dx + fy * dy);
+	double discriminant = b * b - 4 * a * c;
+	if (a == 0 || discriminant < 0)
+		return false;
+	t = (-b - sqrt(discriminant)) / (2 * a);
+	return t >= 0 && t <= 1;
+#endif
+}
+
+// positions outside the grid (e.g. a projectile that flew past the edge of the dish) go in the nearest border cell
+int SpatialGrid::columnOf(double x) const
+{
+	return max(0, min(m_cols - 1, (int)floor(x / m_cellSize)));
+}
+
+int SpatialGrid::rowOf(double y) const
+{
+	return max(0, min(m_rows - 1, (int)floor(y / m_cellSize)));
+}
+
+void SpatialGrid::cellRange(double minX, double minY, double maxX, double maxY, int& c0, int& r0, int& c1, int& r1) const
+{
+	c0 = columnOf(minX);
+	r0 = rowOf(minY);
+	c1 = columnOf(maxX);
+	r1 = rowOf(maxY);
+}
+
+// spread the low 16 bits of v out so there's a zero between each of them
+static unsigned int spreadBits(unsigned int v)
+{
+	v &= 0xFFFF;
+	v = (v | (v << 8)) & 0x00FF00FF;
+	v = (v | (v << 4)) & 0x0F0F0F0F;
+	v = (v | (v << 2)) & 0x33333333;
+	v = (v | (v << 1)) & 0x55555555;
+	return v;
+}
+
+unsigned int SpatialGrid::mortonCode(double x, double y)
+{
+	unsigned int px = (unsigned int)max(0.0, min(65535.0, x));
+	unsigned int py = (unsigned int)max(0.0, min(65535.0, y));
+	return spreadBits(px) | (spreadBits(py) << 1);
+}
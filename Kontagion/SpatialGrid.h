@@ -0,0 +1,117 @@
+#ifndef SPATIALGRID_INCLUDED
+#define SPATIALGRID_INCLUDED
+
+#include <vector>
+#include <algorithm>
+
+class Actor;
+
+// A uniform grid over the Petri dish.  Every actor in the grid lives in the
+// cell containing its center, so a query only has to look at the handful of
+// cells near the query point instead of at every actor in the world.
+class SpatialGrid
+{
+public:
+	SpatialGrid(double width, double height, double cellSize);
+
+	// Add an actor to the cell containing its current position.
+	void insert(Actor* a);
+
+	// Remove an actor that is recorded at (x, y).  Return false if the actor
+	// was not in the grid.
+	bool remove(Actor* a, double x, double y);
+
+	// Move an actor that used to be at (oldX, oldY) to the cell containing
+	// its current position.  Actors that were never inserted are ignored.
+	void update(Actor* a, double oldX, double oldY);
+
+	// Remove every actor from the grid.
+	void clear();
+
+	// Call f on every actor whose cell intersects the box from (minX, minY)
+	// to (maxX, maxY).  If f returns true, stop early and return true.
+	template<typename Func>
+	bool forEachInBox(double minX, double minY, double maxX, double maxY, Func f) const
+	{
+		int c0, r0, c1, r1;
+		cellRange(minX, minY, maxX, maxY, c0, r0, c1, r1);
+		for (int r = r0; r <= r1; r++)
+		{
+			for (int c = c0; c <= c1; c++)
+			{
+				for (Actor* a : m_cells[r * m_cols + c])
+				{
+					if (f(a))
+						return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Call f on every actor that could be within radius of (x, y).
+	template<typename Func>
+	bool forEachNear(double x, double y, double radius, Func f) const
+	{
+		return forEachInBox(x - radius, y - radius, x + radius, y + radius, f);
+	}
+
+	// Call f on every actor that could be within radius of the segment from
+	// (x0, y0) to (x1, y1).  Only the cells the widened segment actually
+	// passes through are visited, not the whole bounding box.
+	template<typename Func>
+	bool forEachAlongSegment(double x0, double y0, double x1, double y1, double radius, Func f) const
+	{
+		int c0, r0, c1, r1;
+		cellRange(std::min(x0, x1) - radius, std::min(y0, y1) - radius,
+			std::max(x0, x1) + radius, std::max(y0, y1) + radius, c0, r0, c1, r1);
+		// a cell can only contain a candidate if its center is within the
+		// radius plus half the cell's diagonal of the segment (border cells
+		// also hold actors that are outside the grid, so always visit them)
+		double reach = radius + m_cellSize * 0.7072;
+		for (int r = r0; r <= r1; r++)
+		{
+			for (int c = c0; c <= c1; c++)
+			{
+				bool border = (c == 0 || r == 0 || c == m_cols - 1 || r == m_rows - 1);
+				double cx = (c + 0.5) * m_cellSize;
+				double cy = (r + 0.5) * m_cellSize;
+				if (!border && distanceSquaredToSegment(cx, cy, x0, y0, x1, y1) > reach * reach)
+					continue;
+				for (Actor* a : m_cells[r * m_cols + c])
+				{
+					if (f(a))
+						return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// How far (squared) is (px, py) from the segment from (x0, y0) to (x1, y1)?
+	static double distanceSquaredToSegment(double px, double py, double x0, double y0, double x1, double y1);
+
+	// Does something moving from (x0, y0) to (x1, y1) come within radius of
+	// (cx, cy)?  If so, set t to the fraction of the way along the segment
+	// where it first does (0 if it starts out that close).
+	static bool firstContactAlongSegment(double cx, double cy, double radius, double x0, double y0, double x1, double y1, double& t);
+
+	// The Z-order (Morton) code of (x, y): the bits of the whole-pixel x and
+	// y coordinates interleaved, so points near each other in the dish
+	// usually get codes near each other.  Sorting actors by this code keeps
+	// neighbours next to each other in memory.  Coordinates are clamped to
+	// 0 through 65535.
+	static unsigned int mortonCode(double x, double y);
+
+private:
+	int m_cols;
+	int m_rows;
+	double m_cellSize;
+	std::vector<std::vector<Actor*>> m_cells;
+
+	int columnOf(double x) const;
+	int rowOf(double y) const;
+	void cellRange(double minX, double minY, double maxX, double maxY, int& c0, int& r0, int& c1, int& r1) const;
+};
+
+#endif // SPATIALGRID_INCLUDED
@@ -0,0 +1,360 @@
+#include "SpriteImage.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+using namespace std;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPRITE_IMAGE_SSE2
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define SPRITE_IMAGE_SSSE3
+#endif
+
+  // The power of two gluBuild2DMipmaps scales a dimension to.
+static int nearestPower(int value)
+{
+    int i = 1;
+    for (;;)
+    {
+        if (value <= 1)
+            return i;
+        if (value == 3)
+            return i * 4;
+        value >>= 1;
+        i *= 2;
+    }
+}
+
+  // Bilinearly resample a level to a new size.  Where each output column
+  // and row samples from is worked out once, with weights in 256ths, so
+  // the loop over pixels is all integer arithmetic.
+static MipLevel resize(const MipLevel& from, int width, int height)
+{
+    struct Tap { int first; int second; int weight; };    // weight of second, in 256ths
+    auto taps = [](int fromSize, int toSize)
+    {
+        vector<Tap> t(toSize);
+        for (int i = 0; i < toSize; i++)
+        {
+            double s = max(0.0, (i + .5) * fromSize / toSize - .5);
+            t[i].first = min(static_cast<int>(s), fromSize - 1);
+            t[i].second = min(t[i].first + 1, fromSize - 1);
+            t[i].weight = static_cast<int>((s - t[i].first) * 256 + .5);
+        }
+        return t;
+    };
+    vector<Tap> columns = taps(from.width, width);
+    vector<Tap> rows = taps(from.height, height);
+
+    MipLevel to;
+    to.width = width;
+    to.height = height;
+    to.texels.resize(4 * width * height);
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t* row0 = &from.texels[4 * rows[y].first * from.width];
+        const uint8_t* row1 = &from.texels[4 * rows[y].second * from.width];
+        int fy = rows[y].weight;
+        uint8_t* out = &to.texels[4 * y * width];
+        for (int x = 0; x < width; x++)
+        {
+            int x0 = 4 * columns[x].first;
+            int x1 = 4 * columns[x].second;
+            int fx = columns[x].weight;
+            for (int c = 0; c < 4; c++)
+            {
+                int top = row0[x0 + c] * (256 - fx) + row0[x1 + c] * fx;
+                int bottom = row1[x0 + c] * (256 - fx) + row1[x1 + c] * fx;
+                out[4 * x + c] = static_cast<uint8_t>((top * (256 - fy) + bottom * fy + 32768) >> 16);
+            }
+        }
+    }
+    return to;
+}
+
+  // Expand count pixels of bytesPerPixel bytes each (BGRA, BGR, or grey)
+  // to BGRA.
+static void expandToBGRA(const uint8_t* in, int bytesPerPixel, uint8_t* out, size_t count)
+{
+    size_t i = 0;
+    if (bytesPerPixel == 4)
+    {
+        memcpy(out, in, 4 * count);
+        return;
+    }
+    if (bytesPerPixel == 3)
+    {
+#ifdef SPRITE_IMAGE_SSSE3
+          // Four pixels at a time: spread 12 bytes out to 16 and fill in
+          // the alpha.  (Each load reads 16 bytes, so stop 6 pixels short.)
+        const __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        for ( ; i + 6 <= count; i += 4)
+        {
+            __m128i bgr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 3 * i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), _mm_or_si128(_mm_shuffle_epi8(bgr, spread), alpha));
+        }
+#endif
+        for ( ; i < count; i++)
+        {
+            out[4 * i]     = in[3 * i];
+            out[4 * i + 1] = in[3 * i + 1];
+            out[4 * i + 2] = in[3 * i + 2];
+            out[4 * i + 3] = 255;
+        }
+        return;
+    }
+#ifdef SPRITE_IMAGE_SSE2
+      // Sixteen grey pixels at a time: interleave each grey byte with
+      // itself and with 255 to make grey, grey, grey, 255.
+    const __m128i opaque = _mm_set1_epi8(-1);
+    for ( ; i + 16 <= count; i += 16)
+    {
+        __m128i grey = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i gg[2] = { _mm_unpacklo_epi8(grey, grey), _mm_unpackhi_epi8(grey, grey) };
+        __m128i ga[2] = { _mm_unpacklo_epi8(grey, opaque), _mm_unpackhi_epi8(grey, opaque) };
+        __m128i* to = reinterpret_cast<__m128i*>(out + 4 * i);
+        for (int h = 0; h < 2; h++)
+        {
+            _mm_storeu_si128(to + 2 * h, _mm_unpacklo_epi16(gg[h], ga[h]));
+            _mm_storeu_si128(to + 2 * h + 1, _mm_unpackhi_epi16(gg[h], ga[h]));
+        }
+    }
+#endif
+    for ( ; i < count; i++)
+    {
+        out[4 * i] = out[4 * i + 1] = out[4 * i + 2] = in[i];
+        out[4 * i + 3] = 255;
+    }
+}
+
+  // Undo run-length encoding: a packet header byte with the top bit set is
+  // followed by one pixel repeated (low 7 bits + 1) times; otherwise it's
+  // followed by that many literal pixels.
+static bool unpackRLE(const uint8_t* in, const uint8_t* end, int bytesPerPixel, uint8_t* out, size_t count)
+{
+    size_t done = 0;
+    while (done < count)
+    {
+        if (in >= end)
+            return false;
+        size_t n = (*in & 0x7F) + 1;
+        bool repeated = (*in & 0x80) != 0;
+        in++;
+        if (n > count - done)
+            return false;
+        if (repeated)
+        {
+            if (end - in < bytesPerPixel)
+                return false;
+            for (size_t k = 0; k < n; k++)
+                memcpy(out + (done + k) * bytesPerPixel, in, bytesPerPixel);
+            in += bytesPerPixel;
+        }
+        else
+        {
+            if (static_cast<size_t>(end - in) < n * bytesPerPixel)
+                return false;
+            memcpy(out + done * bytesPerPixel, in, n * bytesPerPixel);
+            in += n * bytesPerPixel;
+        }
+        done += n;
+    }
+    return true;
+}
+
+  // Decode a whole TGA file held in memory into BGRA, bottom row first.
+static bool decodeTGA(const uint8_t* data, size_t size, MipLevel& image)
+{
+    if (size < 18)
+        return false;
+    int idLength = data[0];
+    int colorMapType = data[1];
+    int imageType = data[2];
+    int width = data[12] + data[13] * 256;
+    int height = data[14] + data[15] * 256;
+    int bytesPerPixel = data[16] / 8;
+    int descriptor = data[17];
+
+      // image type 2 (color), 3 (greyscale), or those run-length encoded (10, 11)
+    if (colorMapType != 0 || (imageType != 2 && imageType != 3 && imageType != 10 && imageType != 11))
+        return false;
+    bool grey = (imageType == 3 || imageType == 11);
+    if (bytesPerPixel != 3 && bytesPerPixel != 4 && !(grey && bytesPerPixel == 1))
+        return false;
+    if (width == 0 || height == 0)
+        return false;
+
+    size_t count = static_cast<size_t>(width) * height;
+    const uint8_t* pixels = data + 18 + idLength;
+    const uint8_t* end = data + size;
+    if (pixels > end)
+        return false;
+    vector<uint8_t> unpacked;
+    if (imageType >= 10)
+    {
+        unpacked.resize(count * bytesPerPixel);
+        if (!unpackRLE(pixels, end, bytesPerPixel, unpacked.data(), count))
+            return false;
+        pixels = unpacked.data();
+    }
+    else if (static_cast<size_t>(end - pixels) < count * bytesPerPixel)
+        return false;
+
+    image.width = width;
+    image.height = height;
+    image.texels.resize(4 * count);
+    expandToBGRA(pixels, bytesPerPixel, image.texels.data(), count);
+
+      // Bits 4 and 5 of the descriptor say whether rows run right to left
+      // and whether the top row comes first; store left to right, bottom up.
+    uint8_t* texels = image.texels.data();
+    if (descriptor & 0x10)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            uint8_t* row = texels + 4 * y * width;
+            for (int x = 0; x < width / 2; x++)
+                swap_ranges(row + 4 * x, row + 4 * x + 4, row + 4 * (width - 1 - x));
+        }
+    }
+    if (descriptor & 0x20)
+    {
+        for (int y = 0; y < height / 2; y++)
+            swap_ranges(texels + 4 * y * width, texels + 4 * (y + 1) * width, texels + 4 * (height - 1 - y) * width);
+    }
+    return true;
+}
+
+  // Average 2x2 blocks.  (An odd last row or column is left out; a
+  // dimension that's already 1 stays 1.)
+static MipLevel halveBox(const MipLevel& from)
+{
+    MipLevel to;
+    to.width = max(1, from.width / 2);
+    to.height = max(1, from.height / 2);
+    to.texels.resize(4 * to.width * to.height);
+    for (int y = 0; y < to.height; y++)
+    {
+        const uint8_t* row0 = &from.texels[4 * min(2 * y, from.height - 1) * from.width];
+        const uint8_t* row1 = &from.texels[4 * min(2 * y + 1, from.height - 1) * from.width];
+        uint8_t* out = &to.texels[4 * y * to.width];
+        int x = 0;
+#ifdef SPRITE_IMAGE_SSE2
+          // Two output pixels at a time from four input pixels in each row:
+          // add the rows in 16 bits, add each pixel to its right neighbor,
+          // and divide by 4, rounding.
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        for ( ; 2 * x + 4 <= from.width; x += 2)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x));
+            __m128i left = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));    // pixels 0 and 1
+            __m128i right = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));   // pixels 2 and 3
+            __m128i sums = _mm_unpacklo_epi64(_mm_add_epi16(left, _mm_srli_si128(left, 8)),
+                                              _mm_add_epi16(right, _mm_srli_si128(right, 8)));
+            sums = _mm_srli_epi16(_mm_add_epi16(sums, two), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(sums, sums));
+        }
+#endif
+        for ( ; x < to.width; x++)
+        {
+            int x0 = min(2 * x, from.width - 1);
+            int x1 = min(2 * x + 1, from.width - 1);
+            for (int c = 0; c < 4; c++)
+            {
+                int sum = row0[4 * x0 + c] + row0[4 * x1 + c] + row1[4 * x0 + c] + row1[4 * x1 + c];
+                out[4 * x + c] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return to;
+}
+
+  // Filter with a tent spanning 4x4 input pixels (weights 1 3 3 1 each way,
+  // edges repeated), which blurs less blockily than the box.  It's done
+  // in two passes, across each row and then down the columns, in 16 bits.
+static MipLevel halveTriangle(const MipLevel& from)
+{
+    MipLevel to;
+    to.width = max(1, from.width / 2);
+    to.height = max(1, from.height / 2);
+    to.texels.resize(4 * to.width * to.height);
+
+    int rowLength = 4 * to.width;
+    vector<uint16_t> across(static_cast<size_t>(from.height) * rowLength);
+    for (int y = 0; y < from.height; y++)
+    {
+        const uint8_t* in = &from.texels[4 * y * from.width];
+        uint16_t* out = &across[y * rowLength];
+        for (int x = 0; x < to.width; x++)
+        {
+            int xa = max(2 * x - 1, 0);
+            int xb = min(2 * x, from.width - 1);
+            int xc = min(2 * x + 1, from.width - 1);
+            int xd = min(2 * x + 2, from.width - 1);
+            for (int c = 0; c < 4; c++)
+                out[4 * x + c] = static_cast<uint16_t>(in[4 * xa + c] + 3 * (in[4 * xb + c] + in[4 * xc + c]) + in[4 * xd + c]);
+        }
+    }
+    for (int y = 0; y < to.height; y++)
+    {
+        const uint16_t* a = &across[max(2 * y - 1, 0) * rowLength];
+        const uint16_t* b = &across[min(2 * y, from.height - 1) * rowLength];
+        const uint16_t* c = &across[min(2 * y + 1, from.height - 1) * rowLength];
+        const uint16_t* d = &across[min(2 * y + 2, from.height - 1) * rowLength];
+        uint8_t* out = &to.texels[y * rowLength];
+          // (a plain loop over the whole row, which compilers vectorize)
+        for (int i = 0; i < rowLength; i++)
+            out[i] = static_cast<uint8_t>((a[i] + 3 * (b[i] + c[i]) + d[i] + 32) >> 6);
+    }
+    return to;
+}
+
+bool loadSpriteImage(string filename_tga, bool powerOfTwo, bool mipmaps, SpriteImage& image, MipFilter filter)
+{
+      // Read the whole file at once, then decode it from memory.
+    ifstream tgaFile(filename_tga, ios::in|ios::binary|ios::ate);
+    if (!tgaFile)
+        return false;
+    streamoff size = tgaFile.tellg();
+    if (size <= 0)
+        return false;
+    vector<uint8_t> file(static_cast<size_t>(size));
+    tgaFile.seekg(0);
+    tgaFile.read(reinterpret_cast<char*>(file.data()), size);
+    if (!tgaFile)
+        return false;
+
+    image.levels.assign(1, MipLevel());
+    if (!decodeTGA(file.data(), file.size(), image.levels[0]))
+        return false;
+    int width = image.levels[0].width;
+    int height = image.levels[0].height;
+
+    if (powerOfTwo && (nearestPower(width) != width || nearestPower(height) != height))
+        image.levels[0] = resize(image.levels[0], nearestPower(width), nearestPower(height));
+
+    while (mipmaps && (image.levels.back().width > 1 || image.levels.back().height > 1))
+    {
+        MipLevel next = (filter == MIP_TRIANGLE ? halveTriangle(image.levels.back()) : halveBox(image.levels.back()));
+        image.levels.push_back(std::move(next));
+    }
+    return true;
+}
+
+vector<MipLevelView> viewLevels(const SpriteImage& image)
+{
+    vector<MipLevelView> views;
+    for (const MipLevel& level : image.levels)
+    {
+        MipLevelView view = { level.width, level.height, level.texels.data() };
+        views.push_back(view);
+    }
+    return views;
+}
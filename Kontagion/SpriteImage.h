@@ -0,0 +1,46 @@
+#ifndef SPRITEIMAGE_H_
+#define SPRITEIMAGE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+  // One level of a sprite's mipmap chain: BGRA pixels, bottom row first.
+struct MipLevel
+{
+    int width;
+    int height;
+    std::vector<std::uint8_t> texels;
+};
+
+  // A sprite decoded from its TGA file: levels[0] is the whole image and,
+  // if mipmaps were made, each level after it is half as big, down to 1x1.
+struct SpriteImage
+{
+    std::vector<MipLevel> levels;
+};
+
+  // A mip level's pixels wherever they live (in a SpriteImage, or straight
+  // out of an asset pack).
+struct MipLevelView
+{
+    int width;
+    int height;
+    const std::uint8_t* texels;
+};
+
+  // Views of all of an image's levels.
+std::vector<MipLevelView> viewLevels(const SpriteImage& image);
+
+  // How each mipmap is made from the one before: averaging 2x2 blocks (what
+  // gluBuild2DMipmaps does), or a smoother 4x4 tent.
+enum MipFilter { MIP_BOX, MIP_TRIANGLE };
+
+  // Read a color or greyscale TGA file, plain or run-length encoded (types
+  // 2, 3, 10 and 11), with 3 or 4 bytes per pixel (or 1, for greyscale),
+  // into image.  If powerOfTwo, the image is first scaled to the nearest
+  // power of two size, as gluBuild2DMipmaps would.  Nothing here touches
+  // OpenGL, so sprites can be decoded on any thread.
+bool loadSpriteImage(std::string filename_tga, bool powerOfTwo, bool mipmaps, SpriteImage& image, MipFilter filter = MIP_BOX);
+
+#endif // SPRITEIMAGE_H_
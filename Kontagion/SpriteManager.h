@@ -12,10 +12,12 @@
 #endif
 
 #include "GameConstants.h"
+#include "SpriteImage.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <map>
+#include <vector>
 #include <memory>
 #include <cmath>
 
@@ -37,43 +39,34 @@ public:
 
     bool loadSprite(std::string filename_tga, int imageID, int frameNum)
     {
-          // Load Texture Data From TGA File
+        SpriteImage image;
+        return decodeSprite(filename_tga, image)  &&  addSprite(image, imageID, frameNum);
+    }
+
+      // Read a sprite's TGA file and make its mipmaps, without touching
+      // OpenGL, so any thread can do it.
+    bool decodeSprite(std::string filename_tga, SpriteImage& image) const
+    {
+        return loadSpriteImage(filename_tga, true, m_mipMapped, image);
+    }
+
+      // Give a decoded sprite to OpenGL.  Only the thread that created the
+      // window may do this.
+    bool addSprite(const SpriteImage& image, int imageID, int frameNum)
+    {
+        return addSprite(viewLevels(image), imageID, frameNum);
+    }
 
+      // The same, for a mipmap chain that's already somewhere in memory
+      // (such as an asset pack), which OpenGL reads straight from.
+    bool addSprite(const std::vector<MipLevelView>& levels, int imageID, int frameNum)
+    {
         int spriteID = getSpriteID(imageID, frameNum);
         if (spriteID == INVALID_SPRITE_ID)
             return false;
 
         m_frameCountPerSprite[imageID]++;   // keep track of how many frames per sprite we loaded
 
-        std::ifstream tgaFile(filename_tga, std::ios::in|std::ios::binary);
-        if (!tgaFile)
-            return false;
-
-        char type[3];
-        char info[6];
-
-          // Read file header info
-        tgaFile.read(type, 3);
-        tgaFile.seekg(12);
-        tgaFile.read(info, 6);
-        unsigned int textureWidth = static_cast<unsigned char>(info[0]) + static_cast<unsigned char>(info[1]) * 256;
-        unsigned int textureHeight = static_cast<unsigned char>(info[2]) + static_cast<unsigned char>(info[3]) * 256;
-        unsigned char byteCount = static_cast<unsigned char>(info[4]) / 8;
-        long imageSize = textureWidth * textureHeight * byteCount;
-        std::unique_ptr<char[]> imageData(new char[imageSize]);
-        tgaFile.seekg(18);
-          // Read image data
-        tgaFile.read(imageData.get(), imageSize);
-        if (!tgaFile)
-            return false;
-
-          //image type either 2 (color) or 3 (greyscale)
-        if (type[1] != 0 || (type[2] != 2 && type[2] != 3))
-            return false;
-
-        if (byteCount != 3 && byteCount != 4)
-            return false;
-
           // Transfer Texture To OpenGL
 
         glEnable(GL_DEPTH_TEST);
@@ -104,19 +97,12 @@ public:
         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_REPEAT));
         glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_REPEAT));
 
-        if (m_mipMapped)
-        {
-              // build our texture mipmaps
-              // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            makeMipmaps(byteCount, textureWidth, textureHeight, imageData.get());
-        }
-        else
+          // The mipmaps (if any) were made when the sprite was decoded.
+        size_t numLevels = (m_mipMapped ? levels.size() : 1);
+        for (size_t level = 0; level < numLevels; level++)
         {
-              // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            if (3 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 3, textureWidth, textureHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, imageData.get());
-            else if (4 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 4, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData.get());
+            const MipLevelView& mip = levels[level];
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA, mip.width, mip.height, 0, GL_BGRA, GL_UNSIGNED_BYTE, mip.texels);
         }
 
         m_imageMap[spriteID] = glTextureID;
@@ -145,9 +131,6 @@ public:
 
         glPushMatrix();
 
-        double finalWidth = SPRITE_WIDTH_GL * size;
-        double finalHeight = SPRITE_HEIGHT_GL * size;
-
         // object's x/y location is center-based, but sprite plotting is upper-left-corner based
         const double xoffset = 0;// finalWidth / 2;
         const double yoffset = 0;// finalHeight / 2;
@@ -169,29 +152,18 @@ public:
         double cx3 = 1, cy3 = 1;
         double cx4 = 0, cy4 = 1;
 
-          // Rotate sprite.  For 180 degrees, don't rotate, but reflect
-        double rx1, ry1, rx2, ry2, rx3, ry3, rx4, ry4;
-        double rotationAngle = (angleDegrees == 180 ? 0 : angleDegrees);
-        rotate(-finalWidth / 2, -finalHeight / 2, rotationAngle, rx1, ry1);
-        rotate( finalWidth / 2, -finalHeight / 2, rotationAngle, rx2, ry2);
-        rotate( finalWidth / 2,  finalHeight / 2, rotationAngle, rx3, ry3);
-        rotate(-finalWidth / 2,  finalHeight / 2, rotationAngle, rx4, ry4);
-        if (angleDegrees == 180)
-        {
-            // No rotation happened, but reflect to face left
-            std::swap(rx1, rx2);
-            std::swap(rx3, rx4);
-        }
+        double rx[4], ry[4];
+        getSpriteCorners(size, angleDegrees, rx, ry);
 
         glBegin(GL_QUADS);
         glTexCoord2d(cx1, cy1);
-        glVertex3f(static_cast<GLfloat>(rx1), static_cast<GLfloat>(ry1), 0);
+        glVertex3f(static_cast<GLfloat>(rx[0]), static_cast<GLfloat>(ry[0]), 0);
         glTexCoord2d(cx2, cy2);
-        glVertex3f(static_cast<GLfloat>(rx2), static_cast<GLfloat>(ry2), 0);
+        glVertex3f(static_cast<GLfloat>(rx[1]), static_cast<GLfloat>(ry[1]), 0);
         glTexCoord2d(cx3, cy3);
-        glVertex3f(static_cast<GLfloat>(rx3), static_cast<GLfloat>(ry3), 0);
+        glVertex3f(static_cast<GLfloat>(rx[2]), static_cast<GLfloat>(ry[2]), 0);
         glTexCoord2d(cx4, cy4);
-        glVertex3f(static_cast<GLfloat>(rx4), static_cast<GLfloat>(ry4), 0);
+        glVertex3f(static_cast<GLfloat>(rx[3]), static_cast<GLfloat>(ry[3]), 0);
         glEnd();
 
         glDisable(GL_TEXTURE_2D);
@@ -203,6 +175,44 @@ public:
         return true;
     }
 
+      // The corners of a sprite's quad, relative to its center, in the order
+      // that gets texture coordinates (0,0), (1,0), (1,1), (0,1).
+    static void getSpriteCorners(double size, int angleDegrees, double rx[4], double ry[4])
+    {
+        double finalWidth = SPRITE_WIDTH_GL * size;
+        double finalHeight = SPRITE_HEIGHT_GL * size;
+
+          // Rotate sprite.  For 180 degrees, don't rotate, but reflect
+        double rotationAngle = (angleDegrees == 180 ? 0 : angleDegrees);
+        rotate(-finalWidth / 2, -finalHeight / 2, rotationAngle, rx[0], ry[0]);
+        rotate( finalWidth / 2, -finalHeight / 2, rotationAngle, rx[1], ry[1]);
+        rotate( finalWidth / 2,  finalHeight / 2, rotationAngle, rx[2], ry[2]);
+        rotate(-finalWidth / 2,  finalHeight / 2, rotationAngle, rx[3], ry[3]);
+        if (angleDegrees == 180)
+        {
+            // No rotation happened, but reflect to face left
+            std::swap(rx[0], rx[1]);
+            std::swap(rx[2], rx[3]);
+        }
+    }
+
+    static void rotate(double x, double y, double degrees, double &xout, double &yout)
+    {
+        static const double PI = 4 * atan(1.0);
+        double theta = degrees * (2 * PI / 360);
+        xout = x * cos(theta) - y * sin(theta);
+        yout = y * cos(theta) + x * sin(theta);
+    }
+
+    static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
+    {
+        x /= VIEW_WIDTH;
+        y /= VIEW_HEIGHT;
+        gx = 2 * VISIBLE_MIN_X + .3 + x * 2 * (VISIBLE_MAX_X - VISIBLE_MIN_X);
+        gy = 2 * VISIBLE_MIN_Y +      y * 2 * (VISIBLE_MAX_Y - VISIBLE_MIN_Y);
+        gz = .6 * VISIBLE_MIN_Z;
+    }
+
     static void drawCircle(float cx, float cy, float r, int num_segments) {
         glBegin(GL_LINE_LOOP);
         for (int ii = 0; ii < num_segments; ii++)
@@ -240,35 +250,6 @@ private:
 
         return imageID * MAX_FRAMES_PER_SPRITE + frame;
     }
-
-    static void rotate(double x, double y, double degrees, double &xout, double &yout)
-    {
-        static const double PI = 4 * atan(1.0);
-        double theta = degrees * (2 * PI / 360);
-        xout = x * cos(theta) - y * sin(theta);
-        yout = y * cos(theta) + x * sin(theta);
-    }
-
-    static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
-    {
-        x /= VIEW_WIDTH;
-        y /= VIEW_HEIGHT;
-        gx = 2 * VISIBLE_MIN_X + .3 + x * 2 * (VISIBLE_MAX_X - VISIBLE_MIN_X);
-        gy = 2 * VISIBLE_MIN_Y +      y * 2 * (VISIBLE_MAX_Y - VISIBLE_MIN_Y);
-        gz = .6 * VISIBLE_MIN_Z;
-    }
-
-    static void makeMipmaps(unsigned char byteCount, unsigned int textureWidth, unsigned int textureHeight, char* imageData)
-    {
-        int format = (byteCount == 3 ? GL_BGR : GL_BGRA);
-#ifdef __APPLE__
-        int internalFormat = (byteCount == 3 ? GL_RGB : GL_RGBA);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, imageData);
-        glGenerateMipmap(GL_TEXTURE_2D);
-#else
-        gluBuild2DMipmaps(GL_TEXTURE_2D, byteCount, textureWidth, textureHeight, format, GL_UNSIGNED_BYTE, imageData);
-#endif
-    }
 };
 
 #endif // SPRITEMANAGER_H_
@@ -1,8 +1,12 @@
 #include "StudentWorld.h"
 #include "Actor.h"
+#include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <list>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdlib>
 using namespace std;
 
 GameWorld* createStudentWorld(string assetPath)
@@ -14,86 +18,197 @@ GameWorld* createStudentWorld(string assetPath)
 /*					   STUDENTWORLD CLASS IMPLEMENTATION                          */
 /**********************************************************************************/
 StudentWorld::StudentWorld(string assetDir)
-	: GameWorld(assetDir)
+	: GameWorld(assetDir), m_grid(VIEW_WIDTH, VIEW_HEIGHT, 2 * SPRITE_WIDTH),
+	  m_foodGrid(VIEW_WIDTH, VIEW_HEIGHT, FOOD_CELL_SIZE), m_particles(this, 1), m_timers(512),
+	  m_jobs(min(max(1, (int)thread::hardware_concurrency()) - 1, (int)MAX_TICK_WORKERS))
 {
+	// every actor created from now on belongs to this world
+	Actor::setWorld(this);
+	m_currentTicking = -1;
+	m_tickStatus = GWSTATUS_CONTINUE_GAME;
+	m_dishRadius = VIEW_RADIUS;
+	m_numPits = -1;
+	m_pitQuota[0] = 5;
+	m_pitQuota[1] = 3;
+	m_pitQuota[2] = 2;
+	m_foodDensity = -1;
+	m_socratesInvulnerable = false;
+	m_reportFootprint = false;
+	m_reportTickJobs = false;
+	m_spatialSortInterval = SPATIAL_SORT_INTERVAL;
+	m_virtualDispatch = false;
+	buildTickGraph();
+	for (int i = 0; i < NUM_ACTOR_TYPES; i++)
+	{
+		m_typeCounts[i] = 0;
+		m_peakTypeCounts[i] = 0;
+	}
 }
 
 StudentWorld::~StudentWorld()
 {
-	for (auto it = m_actors.begin(); it != m_actors.end();)
+	deleteAllActors();
+	Actor::setWorld(nullptr);
+	if (m_reportFootprint)
+		cout << footprintReport();
+	if (m_reportTickJobs)
+		cout << "Tick jobs (" << m_jobs.numWorkers() << " worker threads plus the game's):" << endl << tickGraphReport();
+	cout << m_counters.report();
+	if (m_ai.enabled())
+	{
+		const AIBudgetStats& ai = m_ai.stats();
+		cout << "AI budget: " << ai.budgetMicros << " us per tick, " << ai.overrunTicks << " ticks over it (worst by "
+			<< ai.worstOverrunMicros << " us); far bacteria were re-planning every " << ai.stride << " ticks at the end" << endl;
+	}
+	if (m_events.isOpen())
 	{
-		delete (*it);
-		it = m_actors.erase(it);
+		// waits for the writer to finish, so every count is final
+		m_events.close();
+		cout << "Event log: " << m_events.written() << " events written, " << m_events.dropped() << " dropped" << endl;
 	}
 }
 
 int StudentWorld::init()
 {
-	// place Socrates at (0, 128)
-	m_player = new Socrates(this, 0, VIEW_HEIGHT/2);
-	// place Pit(s) randomly without overlap; number of pits in game = level
-	for (int i = 0; i < getLevel(); i++)
+	// place Socrates at the left edge of the dish, (0, 128) in the standard one
+	m_player = new Socrates(0, m_dishRadius);
+	// place Pit(s) randomly without overlap; number of pits in game = level (unless set with -pits)
+	int numPits = (m_numPits >= 0 ? m_numPits : getLevel());
+	int placed = 0;
+	for (; placed < numPits; placed++)
 	{
 		double x, y;
-		generateRandomPos(x, y);
-		Actor* temp = new Pit(this, x, y);
+		if (!generateRandomPos(x, y))
+			break;
+		Actor* temp = new Pit(x, y, m_pitQuota[0], m_pitQuota[1], m_pitQuota[2]);
 		addActor(temp);
 	}
-	// place Food items randomly without overlap
-	for (int i = 0; i < min(5 * getLevel(), 25); i++)
+	reportCrowding("pits", placed, numPits);
+	// place Food items randomly without overlap; a bigger dish gets proportionally more food and dirt
+	double area = dishAreaScale();
+	int numFood = (int)(min(5 * getLevel(), 25) * area + 0.5);
+	if (m_foodDensity >= 0)
+		numFood = (int)(m_foodDensity * PI * m_dishRadius * m_dishRadius / 10000 + 0.5);
+	for (placed = 0; placed < numFood; placed++)
 	{
 		double x, y;
-		generateRandomPos(x, y);
-		Actor* temp = new Food(this, x, y);
+		if (!generateRandomPos(x, y))
+			break;
+		Actor* temp = new Food(x, y);
 		addActor(temp);
 	}
+	reportCrowding("food items", placed, numFood);
 	// place Dirt items randomly, allowing overlap with other Dirt piles
-	for (int i = 0; i < max(180 - 20 * getLevel(), 20); i++)
+	int numDirt = (int)(max(180 - 20 * getLevel(), 20) * area + 0.5);
+	for (placed = 0; placed < numDirt; placed++)
 	{
 		double x = -1480234;
 		double y = 1480234;
-		generateRandomPos(x, y);
-		Actor* temp = new Dirt(this, x, y);
+		if (!generateRandomPos(x, y))
+			break;
+		Actor* temp = new Dirt(x, y);
 		addActor(temp);
 	}
+	reportCrowding("dirt piles", placed, numDirt);
 	return 1;
 }
 
+void StudentWorld::reportCrowding(const char* what, int placed, int wanted) const
+{
+	// only a stress setting asking for more pits or food than the dish can hold gets here
+	if (placed < wanted)
+		cout << "The Petri dish only had room for " << placed << " of the " << wanted << " " << what << endl;
+}
+
 int StudentWorld::move()
 {
-	m_player->doSomething();
+	act(m_player);
 	// if player made a move that caused it to die, return immediately
 	if (m_player->isDead())
 	{
 		decLives();
+		publishFeed();
+		m_counters.endTick();
 		return GWSTATUS_PLAYER_DIED;
 	}
-	// let all the other actors make a move
-	for (auto it = m_actors.begin(); it != m_actors.end();)
+	// the rest of the tick is a graph of jobs (see buildTickGraph), so the parts that don't depend on each other can run at once
+	m_tickStatus = GWSTATUS_CONTINUE_GAME;
+	m_tickGraph.run(m_jobs);
+	m_counters.endTick();
+	return m_tickStatus;
+}
+
+void StudentWorld::buildTickGraph()
+{
+	// Socrates is done moving, so work out where he is relative to every bacterium in one go
+	int queries = m_tickGraph.add("socrates queries", [this]()
 	{
-		(*it)->doSomething();
-		if ((*it)->isDead())
-		{
-			delete* it;
-			it = m_actors.erase(it);
-		}
-		else
+		m_socratesQueries.resize(m_ticking.size());
+		double x = m_player->getX();
+		double y = m_player->getY();
+		m_jobs.parallelFor(m_ticking.size(), QUERY_GRAIN, [this, x, y](int begin, int end)
 		{
-			it++;
-		}
-	}
-	// check if all bacterias and pits have disappeared
-	bool timeToAdvance = true;
-	for (auto it = m_actors.begin(); it != m_actors.end(); it++)
+			m_socratesQueries.run(m_ticking, x, y, begin, end);
+		});
+	});
+	// Everything from here to removing the dead has to stay in order: bacteria, goodies, pits and
+	// sprays all change the same actors, the grid, and Socrates, and share one random number
+	// generator, so they can't be split up (by region or otherwise) without changing the game.
+	int bacteria = m_tickGraph.add("bacteria", [this]() { moveBacteria(); }, { queries });
+	// goodies only need attention when Socrates touches them or they expire, and pits only when they release a bacterium
+	int goodies = m_tickGraph.add("goodie pickup", [this]() { pickUpGoodies(); }, { bacteria });
+	int timers = m_tickGraph.add("timers", [this]() { runTimers(); }, { goodies });
+	// move all the sprays and flames at once
+	int particles = m_tickGraph.add("particles", [this]() { m_particles.update(); }, { timers });
+	// actors that died stay in the world until the end of the tick, so nothing is deleted while others might be looking at it
+	int dead = m_tickGraph.add("remove dead", [this]()
 	{
-		if ((*it)->preventsLevelCompleting())
+		removeDeadActors();
+		// check if all bacterias and pits have disappeared
+		if (numLevelBlockers() == 0)
 		{
-			timeToAdvance = false;
-			break;
+			m_tickStatus = GWSTATUS_FINISHED_LEVEL;
+			logEvent(EVENT_LEVEL_COMPLETE, m_player, CAUSE_NONE);
 		}
+	}, { particles });
+	// the status bar only looks at Socrates and the score, which nothing below changes,
+	// so it's put together while the actors are being sorted and new ones added
+	m_tickGraph.add("status text", [this]()
+	{
+		if (m_tickStatus == GWSTATUS_CONTINUE_GAME)
+			updateStatusText();
+	}, { dead });
+	// every so often, put actors that have wandered out of spatial order back in it
+	int order = m_tickGraph.add("spatial order", [this]()
+	{
+		if (m_tickStatus == GWSTATUS_CONTINUE_GAME && m_spatialSortInterval > 0 && m_timers.currentTick() % m_spatialSortInterval == 0)
+			restoreSpatialOrder();
+	}, { dead });
+	int spawn = m_tickGraph.add("spawn", [this]()
+	{
+		if (m_tickStatus == GWSTATUS_CONTINUE_GAME)
+			addFungusAndGoodies();
+	}, { order });
+	// the feed goes out once every actor is where it'll be drawn
+	m_tickGraph.add("feed", [this]() { publishFeed(); }, { spawn });
+}
+
+void StudentWorld::moveBacteria()
+{
+	// let all the bacteria make a move (including any that get added along the way)
+	// dirt and food never do anything, so they aren't even looked at
+	m_ai.beginTick();
+	for (size_t i = 0; i < m_ticking.size(); i++)
+	{
+		m_currentTicking = i;
+		act(m_ticking[i]);
 	}
-	if (timeToAdvance)
-		return GWSTATUS_FINISHED_LEVEL;
+	m_currentTicking = -1;
+	m_ai.endTick();
+}
+
+void StudentWorld::addFungusAndGoodies()
+{
 	// add new objects (e.g. goodie or fungus)
 	int chanceNewFungus = max(510 - getLevel() * 10, 200);
 	int tempRand = randInt(0, chanceNewFungus);
@@ -102,7 +217,7 @@ int StudentWorld::move()
 		double dx, dy;
 		int angle = randInt(0, 359);
 		getPositionOnCircumference(angle, dx, dy);
-		addActor(new Fungus(this, dx, dy));
+		addActor(new Fungus(dx, dy));
 	}
 	// if a new goodie is created, the probability of each type is listed below
 	// Extra Life Goodie: 10%
@@ -117,12 +232,16 @@ int StudentWorld::move()
 		getPositionOnCircumference(angle, dx, dy);
 		tempRand = randInt(1, 10);
 		if (tempRand == 1)
-			addActor(new ExtraLifeGoodie(this, dx, dy));
+			addActor(new ExtraLifeGoodie(dx, dy));
 		else if (tempRand > 1 && tempRand < 5)
-			addActor(new FlamethrowerGoodie(this, dx, dy));
+			addActor(new FlamethrowerGoodie(dx, dy));
 		else
-			addActor(new RestoreHealthGoodie(this, dx, dy));
+			addActor(new RestoreHealthGoodie(dx, dy));
 	}
+}
+
+void StudentWorld::updateStatusText()
+{
 	// print/update status bar
 	ostringstream oss;
 	int k;
@@ -134,142 +253,662 @@ int StudentWorld::move()
 	oss << "Score: " << setw(6) << getScore();
 	oss << "  Level: " << getLevel() << "  Lives: " << getLives() << "  health: " << m_player->numHitPoints() << "  Sprays: " << m_player->numSprays() << "  Flames: " << m_player->numFlames();
 	setGameStatText(oss.str());
-	return GWSTATUS_CONTINUE_GAME;
 }
 
 void StudentWorld::cleanUp()
 {
 	delete m_player;
-	for (auto it = m_actors.begin(); it != m_actors.end();)
+	deleteAllActors();
+	m_particles.clear();
+}
+
+void StudentWorld::addActor(Actor* a, EventCause cause)
+{
+	logEvent(EVENT_SPAWN, a, cause);
+	a->setHandle(m_actors.insert(a));
+	m_grid.insert(a);
+	if (a->isEdible())
+		m_foodGrid.insert(a);
+	// keep count of each type of actor (in particular pits and bacteria) so we never have to search for them
+	m_typeCounts[a->type()]++;
+	m_peakTypeCounts[a->type()] = max(m_peakTypeCounts[a->type()], m_typeCounts[a->type()]);
+	// bacteria act every tick; pits and goodies sleep until they have something to do
+	if (a->isBacterium())
+		m_ticking.push_back(a);
+	else if (a->type() == ACTOR_PIT)
+		scheduleActor(a, static_cast<Pit*>(a)->ticksUntilNextRelease());
+	else if (a->type() != ACTOR_DIRT && a->type() != ACTOR_FOOD)
+		scheduleActor(a, static_cast<Goodie*>(a)->lifetime());
+}
+
+void StudentWorld::actorDied(Actor* a)
+{
+	// Socrates isn't stored with the other actors, so he isn't removed this way
+	if (getActor(a->handle()) == a)
+		m_dying.push_back(a);
+}
+
+void StudentWorld::scheduleActor(Actor* a, int delay)
+{
+	m_timers.schedule(a->handle(), delay);
+}
+
+bool StudentWorld::mayReplan(Actor* a) const
+{
+	if (!m_ai.enabled())
+		return true;
+	// bacteria are split into groups by their slot in the world
+	int i = batchIndexOf(a);
+	double dist = i >= 0 ? m_socratesQueries.distance(i) : a->getDistance(m_player->getX(), m_player->getY());
+	return m_ai.mayReplan(a->handle().index, dist, m_timers.currentTick());
+}
+
+void StudentWorld::setAIBudget(double micros)
+{
+	m_ai.setBudget(micros);
+}
+
+const AIBudgetStats& StudentWorld::aiBudgetStats() const
+{
+	return m_ai.stats();
+}
+
+void StudentWorld::pickUpGoodies()
+{
+	// only goodies in the grid cells around Socrates could be touching him
+	vector<Goodie*> touching;
+	m_grid.forEachNear(m_player->getX(), m_player->getY(), SPRITE_WIDTH + 1, [&](Actor* other)
+	{
+		COUNT_EVENT(COUNTER_ACTOR_COMPARISONS);
+		ActorType t = other->type();
+		bool isGoodie = (t == ACTOR_RESTORE_HEALTH_GOODIE || t == ACTOR_FLAMETHROWER_GOODIE || t == ACTOR_EXTRA_LIFE_GOODIE || t == ACTOR_FUNGUS);
+		if (isGoodie && !other->isDead() && getOverlappingSocrates(other) != nullptr)
+			touching.push_back(static_cast<Goodie*>(other));
+		return false;
+	});
+	for (auto it = touching.begin(); it != touching.end(); it++)
+		(*it)->pickUp(m_player);
+}
+
+void StudentWorld::act(Actor* a)
+{
+	if (m_virtualDispatch)
+		a->doSomething();
+	else
+		a->update();
+}
+
+void StudentWorld::runTimers()
+{
+	m_due.clear();
+	m_timers.advance(m_due);
+	for (auto it = m_due.begin(); it != m_due.end(); it++)
 	{
-		delete (*it);
-		it = m_actors.erase(it);
+		// the actor may have died (and been removed) since it was scheduled
+		Actor* a = getActor(*it);
+		if (a != nullptr && !a->isDead())
+			act(a);
 	}
 }
 
-void StudentWorld::addActor(Actor* a)
+Actor* StudentWorld::getActor(ActorHandle h) const
+{
+	return m_actors.get(h);
+}
+
+void StudentWorld::removeActor(Actor* a)
+{
+	m_actors.erase(a->handle());
+	m_grid.remove(a, a->getX(), a->getY());
+	if (a->isEdible())
+		m_foodGrid.remove(a, a->getX(), a->getY());
+	m_typeCounts[a->type()]--;
+	delete a;
+}
+
+void StudentWorld::removeDeadActors()
 {
-	m_actors.push_back(a);
+	// drop dead bacteria from the list of actors that act every tick (keeping the rest in order)
+	m_ticking.erase(remove_if(m_ticking.begin(), m_ticking.end(), [](Actor* a) { return a->isDead(); }), m_ticking.end());
+	// then delete everything that died this tick
+	for (auto it = m_dying.begin(); it != m_dying.end(); it++)
+		removeActor(*it);
+	m_dying.clear();
 }
 
-// generates a valid random position for Actors to be placed in the arena
-void StudentWorld::generateRandomPos(double& x, double& y)
+// are more than 1 in 8 neighbouring keys out of order?
+static bool isDisordered(const vector<unsigned int>& keys)
 {
-	while (!isValid(x, y))
+	size_t descents = 0;
+	for (size_t i = 1; i < keys.size(); i++)
 	{
+		if (keys[i] < keys[i - 1])
+			descents++;
+	}
+	return descents * 8 > keys.size();
+}
+
+void StudentWorld::restoreSpatialOrder()
+{
+	// bacteria move in the order they're in m_ticking, so sorting it means each one's
+	// neighbourhood queries look at the same few grid cells the previous one just did
+	m_mortonKeys.clear();
+	for (size_t i = 0; i < m_ticking.size(); i++)
+		m_mortonKeys.push_back(SpatialGrid::mortonCode(m_ticking[i]->getX(), m_ticking[i]->getY()));
+	if (isDisordered(m_mortonKeys))
+	{
+		m_mortonOrder.clear();
+		for (size_t i = 0; i < m_ticking.size(); i++)
+			m_mortonOrder.push_back(make_pair(m_mortonKeys[i], m_ticking[i]));
+		stable_sort(m_mortonOrder.begin(), m_mortonOrder.end(),
+			[](const pair<unsigned int, Actor*>& a, const pair<unsigned int, Actor*>& b) { return a.first < b.first; });
+		for (size_t i = 0; i < m_ticking.size(); i++)
+			m_ticking[i] = m_mortonOrder[i].second;
+	}
+	// do the same for the packed array of every actor, whose order food searches break ties by
+	m_mortonKeys.clear();
+	for (int i = 0; i < m_actors.size(); i++)
+		m_mortonKeys.push_back(SpatialGrid::mortonCode(m_actors.at(i)->getX(), m_actors.at(i)->getY()));
+	if (isDisordered(m_mortonKeys))
+		m_actors.sortByKey(m_mortonKeys);
+}
+
+int StudentWorld::batchIndexOf(const Actor* a) const
+{
+	// only the bacterium that's moving right now can use the batch, and only until it moves
+	if (m_currentTicking < 0 || m_ticking[m_currentTicking] != a)
+		return -1;
+	if (!m_socratesQueries.isFor(m_currentTicking, a->getX(), a->getY()))
+		return -1;
+	return m_currentTicking;
+}
+
+void StudentWorld::deleteAllActors()
+{
+	for (int i = 0; i < m_actors.size(); i++)
+		delete m_actors.at(i);
+	m_actors.clear();
+	m_grid.clear();
+	m_foodGrid.clear();
+	m_ticking.clear();
+	m_dying.clear();
+	m_timers.clear();
+	m_socratesQueries.clear();
+	for (int i = 0; i < NUM_ACTOR_TYPES; i++)
+		m_typeCounts[i] = 0;
+}
+
+int StudentWorld::numLevelBlockers() const
+{
+	return m_typeCounts[ACTOR_PIT] + m_typeCounts[ACTOR_ECOLI] + m_typeCounts[ACTOR_REGULAR_SALMONELLA] + m_typeCounts[ACTOR_AGGRESSIVE_SALMONELLA];
+}
+
+// the size of each type of actor, and its name for the report
+static size_t actorSize(ActorType type)
+{
+	switch (type)
+	{
+	case ACTOR_DIRT:					return sizeof(Dirt);
+	case ACTOR_FOOD:					return sizeof(Food);
+	case ACTOR_PIT:						return sizeof(Pit);
+	case ACTOR_RESTORE_HEALTH_GOODIE:	return sizeof(RestoreHealthGoodie);
+	case ACTOR_FLAMETHROWER_GOODIE:		return sizeof(FlamethrowerGoodie);
+	case ACTOR_EXTRA_LIFE_GOODIE:		return sizeof(ExtraLifeGoodie);
+	case ACTOR_FUNGUS:					return sizeof(Fungus);
+	case ACTOR_SOCRATES:				return sizeof(Socrates);
+	case ACTOR_ECOLI:					return sizeof(EColi);
+	case ACTOR_REGULAR_SALMONELLA:		return sizeof(RegularSalmonella);
+	case ACTOR_AGGRESSIVE_SALMONELLA:	return sizeof(AggressiveSalmonella);
+	default:							return 0;
+	}
+}
+
+static const char* const ACTOR_TYPE_NAMES[NUM_ACTOR_TYPES] =
+{
+	"dirt", "food", "pit", "restore health goodie", "flamethrower goodie", "extra life goodie",
+	"fungus", "Socrates", "E. coli", "regular salmonella", "aggressive salmonella",
+};
+
+size_t StudentWorld::indexBytesPerActor(ActorType type) const
+{
+	// Socrates is only in the drawing registry
+	if (type == ACTOR_SOCRATES)
+		return sizeof(GraphObject*);
+	// every other actor has an entry in the drawing registry, the slot map (the packed pointer, its slot number, and the slot) and the grid
+	size_t bytes = sizeof(GraphObject*) + sizeof(Actor*) + sizeof(int) + 2 * sizeof(int) + sizeof(Actor*);
+	// bacteria are also in the ticking list; pits and goodies have a timer instead
+	if (type == ACTOR_ECOLI || type == ACTOR_REGULAR_SALMONELLA || type == ACTOR_AGGRESSIVE_SALMONELLA)
+		bytes += sizeof(Actor*);
+	else if (type != ACTOR_DIRT && type != ACTOR_FOOD)
+		bytes += sizeof(ActorHandle) + sizeof(long);
+	return bytes;
+}
+
+string StudentWorld::footprintReport() const
+{
+	ostringstream oss;
+	oss << "Actor memory footprint (peak number alive at once during this game):" << endl;
+	oss << "  " << left << setw(24) << "type" << right << setw(8) << "object" << setw(8) << "index" << setw(8) << "total" << setw(8) << "peak" << setw(10) << "peak KB" << endl;
+	size_t totalBytes = 0;
+	for (int i = 0; i < NUM_ACTOR_TYPES; i++)
+	{
+		ActorType type = static_cast<ActorType>(i);
+		// Socrates isn't one of the world's actors, and there's always exactly one
+		int peak = (type == ACTOR_SOCRATES ? 1 : m_peakTypeCounts[i]);
+		size_t each = actorSize(type) + indexBytesPerActor(type);
+		totalBytes += each * peak;
+		oss << "  " << left << setw(24) << ACTOR_TYPE_NAMES[i] << right << setw(8) << actorSize(type) << setw(8) << indexBytesPerActor(type)
+			<< setw(8) << each << setw(8) << peak << setw(10) << fixed << setprecision(1) << each * peak / 1024.0 << endl;
+	}
+	oss << "  total: " << fixed << setprecision(1) << totalBytes / 1024.0 << " KB; ";
+	oss << "E. coli per MB: " << (1 << 20) / (actorSize(ACTOR_ECOLI) + indexBytesPerActor(ACTOR_ECOLI)) << endl;
+#ifdef KONTAGION_HEAP_ACTORS
+	oss << "  (object sizes don't include the heap's own per-allocation overhead)" << endl;
+#else
+	oss << "  (each type's actors are packed into blocks of its own, with no per-allocation overhead)" << endl;
+#endif
+	// what the compact layout doesn't do (yet)
+#ifdef KONTAGION_FIXED_POINT
+	oss << "  (about 1.6x the bacteria per MB of the original layout, short of 2x: the drawing state still lives in each actor's GraphObject)" << endl;
+#else
+	oss << "  (about 1.5x the bacteria per MB of the original layout, short of 2x: the drawing state still lives in each actor's GraphObject, and positions are still doubles)" << endl;
+#endif
+	return oss.str();
+}
+
+bool StudentWorld::setOption(string name, string value)
+{
+	if (name == "feed")
+	{
+		if (m_feed.open(value, ACTOR_TYPE_NAMES, NUM_ACTOR_TYPES))
+			cout << "Publishing the world's state to " << value << endl;
+		else
+			cout << "Cannot open feed file " << value << endl;
+		return true;
+	}
+	if (name == "events")
+	{
+		if (m_events.open(value, ACTOR_TYPE_NAMES, NUM_ACTOR_TYPES))
+			cout << "Logging events to " << value << endl;
+		else
+			cout << "Cannot open event log " << value << endl;
+		return true;
+	}
+	// the stress settings come from the command line, before the first level is set up
+	// (the dish can't change size once there are actors in the grids)
+	if (name == "dishRadius")
+	{
+		m_dishRadius = max(2 * SPRITE_WIDTH, min(atoi(value.c_str()), (int)MAX_DISH_RADIUS));
+		m_grid = SpatialGrid(2 * m_dishRadius, 2 * m_dishRadius, 2 * SPRITE_WIDTH);
+		m_foodGrid = SpatialGrid(2 * m_dishRadius, 2 * m_dishRadius, FOOD_CELL_SIZE);
+		setWorldSize(2 * m_dishRadius);
+		cout << "Petri dish radius: " << m_dishRadius << endl;
+		return true;
+	}
+	if (name == "pits")
+	{
+		m_numPits = max(0, atoi(value.c_str()));
+		return true;
+	}
+	if (name == "pitQuota")
+	{
+		// "r,a,e"; any numbers left out stay as they were
+		istringstream iss(value);
+		string count;
+		for (int i = 0; i < 3 && getline(iss, count, ','); i++)
+			m_pitQuota[i] = max(0, atoi(count.c_str()));
+		return true;
+	}
+	if (name == "aiBudget")
+	{
+		setAIBudget(max(0.0, atof(value.c_str())));
+		return true;
+	}
+	if (name == "footprint")
+	{
+		m_reportFootprint = (atoi(value.c_str()) != 0);
+		return true;
+	}
+	if (name == "tickJobs")
+	{
+		m_reportTickJobs = (atoi(value.c_str()) != 0);
+		return true;
+	}
+	if (name == "spatialSort")
+	{
+		m_spatialSortInterval = max(0, atoi(value.c_str()));
+		return true;
+	}
+	if (name == "dispatch")
+	{
+		if (value != "virtual" && value != "switch")
+			return false;
+		m_virtualDispatch = (value == "virtual");
+		return true;
+	}
+	if (name == "invulnerable")
+	{
+		m_socratesInvulnerable = (atoi(value.c_str()) != 0);
+		return true;
+	}
+	if (name == "foodDensity")
+	{
+		m_foodDensity = max(0.0, min(atof(value.c_str()), MAX_FOOD_DENSITY));
+		return true;
+	}
+	return false;
+}
+
+void StudentWorld::logEvent(EventKind kind, const Actor* a, EventCause cause, int other, int amount)
+{
+	if (!m_events.isOpen())
+		return;
+	GameEvent e;
+	e.tick = static_cast<uint32_t>(m_timers.currentTick());
+	e.level = static_cast<uint16_t>(getLevel());
+	e.kind = static_cast<uint8_t>(kind);
+	e.cause = static_cast<uint8_t>(cause);
+	e.actor = static_cast<uint8_t>(a->type());
+	e.other = static_cast<uint8_t>(other);
+	e.amount = static_cast<int16_t>(amount);
+	e.x = static_cast<int16_t>(a->getX());
+	e.y = static_cast<int16_t>(a->getY());
+	m_events.record(e);
+}
+
+void StudentWorld::publishFeed()
+{
+	if (!m_feed.isOpen())
+		return;
+	// filled in right in the shared memory, so readers never cost the game a copy
+	FeedRecord& r = m_feed.beginRecord();
+	r.level = getLevel();
+	r.tick = m_timers.currentTick();
+	r.score = getScore();
+	r.lives = getLives();
+	r.socratesHealth = m_player->numHitPoints();
+	r.socratesSprays = m_player->numSprays();
+	r.socratesFlames = m_player->numFlames();
+	// positions have to fit in 16 bits, so a big dish gets them in coarser steps
+	int scale = FEED_POSITION_SCALE;
+	while (scale > 1 && 2 * m_dishRadius * scale > INT16_MAX)
+		scale /= 2;
+	r.positionScale = scale;
+	r.socratesX = static_cast<int16_t>(m_player->getX() * scale);
+	r.socratesY = static_cast<int16_t>(m_player->getY() * scale);
+	for (int i = 0; i < FEED_MAX_TYPES; i++)
+		r.typeCounts[i] = (i < NUM_ACTOR_TYPES ? m_typeCounts[i] : 0);
+	r.typeCounts[ACTOR_SOCRATES] = 1;
+	r.numActors = m_actors.size();
+	r.numPositions = min(r.numActors, FEED_MAX_ACTORS);
+	for (int i = 0; i < r.numPositions; i++)
+	{
+		Actor* a = m_actors.at(i);
+		r.positions[i].x = static_cast<int16_t>(a->getX() * scale);
+		r.positions[i].y = static_cast<int16_t>(a->getY() * scale);
+		r.positions[i].type = static_cast<uint16_t>(a->type());
+	}
+	m_feed.publish();
+}
+
+const CounterSnapshot& StudentWorld::tickCounters() const
+{
+	return m_counters.lastTick();
+}
+
+string StudentWorld::tickGraphReport() const
+{
+	return m_tickGraph.report();
+}
+
+int StudentWorld::numActors(ActorType type) const
+{
+	return m_typeCounts[type];
+}
+
+void StudentWorld::addSpray(double x, double y, int dir)
+{
+	// sprays travel 112 pixels and do 2 points of damage
+	m_particles.launch(IID_SPRAY, x, y, dir, 112, 2);
+}
+
+void StudentWorld::addFlame(double x, double y, int dir)
+{
+	// flames travel 32 pixels and do 5 points of damage
+	m_particles.launch(IID_FLAME, x, y, dir, 32, 5);
+}
+
+void StudentWorld::actorMoved(Actor* a, double oldX, double oldY)
+{
+	m_grid.update(a, oldX, oldY);
+	if (a->isEdible())
+		m_foodGrid.update(a, oldX, oldY);
+}
+
+// generates a valid random position for Actors to be placed in the arena, or returns false if the dish seems to be full
+bool StudentWorld::generateRandomPos(double& x, double& y)
+{
+	// actors are placed at least a sprite's width in from the edge (120 pixels from the center in the standard dish)
+	int center = m_dishRadius;
+	int radius = m_dishRadius - SPRITE_WIDTH;
+	for (int tries = 0; tries == 0 || !isValid(x, y); tries++)
+	{
+		if (tries == MAX_PLACEMENT_TRIES)
+			return false;
 		// generate random x value within width of petri dish
-		x = randInt(VIEW_WIDTH / 2 - 120, VIEW_WIDTH / 2 + 120);
+		x = randInt(center - radius, center + radius);
 		// based on x value above, generate a range of possible y values using formula for circle
-		int maxY = (int)(VIEW_RADIUS + sqrt(-1984 - pow(x, 2) + 256 * x));
-		int minY = (int)(VIEW_RADIUS - sqrt(-1984 - pow(x, 2) + 256 * x));
+#ifdef KONTAGION_FIXED_POINT
+		// the same range as below, from an integer square root (rounded down for maxY and up for minY)
+		int64_t squared = (int64_t)radius * radius - (int64_t)(x - center) * (x - center);
+		int root = (int)integerSqrt(squared);
+		int maxY = center + root;
+		int minY = center - (root * root < squared ? root + 1 : root);
+#else
+		int maxY = (int)(center + sqrt(pow(radius, 2) - pow(x - center, 2)));
+		int minY = (int)(center - sqrt(pow(radius, 2) - pow(x - center, 2)));
+#endif
 		// generate random y value within range
 		y = randInt(minY, maxY);
 	}
+	return true;
 }
 
 // checks if random position generated is a valid one
 bool StudentWorld::isValid(double& x, double& y) const
 {
-	// is this position within 120 pixels of the center of the arena?
-	if (pow(x - 128, 2) + pow(y - 128, 2) > pow(120, 2))
+	// is this position within 120 pixels of the center of the arena (or as far in from the edge of a bigger dish)?
+#ifdef KONTAGION_FIXED_POINT
+	Fixed center = m_dishRadius * FIXED_ONE;
+	int64_t limit = (int64_t)(m_dishRadius - SPRITE_WIDTH) * FIXED_ONE;
+	if (fixedDistanceSquared(fixedFromDouble(x), fixedFromDouble(y), center, center) > limit * limit)
+		return false;
+#else
+	if (pow(x - m_dishRadius, 2) + pow(y - m_dishRadius, 2) > pow(m_dishRadius - SPRITE_WIDTH, 2))
 		return false;
-	for (auto it = m_actors.begin(); it != m_actors.end(); it++)
+#endif
+	// only actors in nearby cells of the grid can overlap this position
+	bool overlaps = m_grid.forEachNear(x, y, SPRITE_WIDTH, [&](Actor* other)
 	{
+		COUNT_EVENT(COUNTER_ACTOR_COMPARISONS);
 		// if this position overlaps with other Dirt piles, it's fine. Continue the loop.
-		if ((*it)->blocksBacteriumMovement())
-			continue;
-		// if this position overlaps with non-Dirt items, return false
-		if ((*it)->isOverlapping(x, y))
-			return false;
-	}
-	return true;
+		// if this position overlaps with non-Dirt items, stop
+		return !other->blocksBacteriumMovement() && other->isOverlapping(x, y);
+	});
+	return !overlaps;
 }
 
 Socrates* StudentWorld::getOverlappingSocrates(Actor* a) const
 {
-	// check if overlapping with Socrates
-	if (a->isOverlapping(m_player->getX(), m_player->getY()))
+	// check if overlapping with Socrates (using this tick's batch if it has the answer)
+	int i = batchIndexOf(a);
+	if (i >= 0 ? m_socratesQueries.overlaps(i) : a->isOverlapping(m_player->getX(), m_player->getY()))
 		return m_player;
 	return nullptr;
 }
 
 Actor* StudentWorld::getOverlappingEdible(Actor* a) const
 {
-	// check each actor to see if actor is food and overlaps with our passed-in actor a 
-	for (auto it = m_actors.begin(); it != m_actors.end(); it++)
+	// check each nearby actor to see if actor is living food and overlaps with our passed-in actor a
+	COUNT_EVENT(COUNTER_EDIBLE_QUERIES);
+	Actor* edible = nullptr;
+	m_grid.forEachNear(a->getX(), a->getY(), SPRITE_WIDTH + 1, [&](Actor* other)
 	{
-		if (a->isOverlapping((*it)->getX(), (*it)->getY()) && (*it)->isEdible())
-			return (*it);
-	}
-	return nullptr;
+		COUNT_EVENT(COUNTER_ACTOR_COMPARISONS);
+		if (!other->isDead() && a->isOverlapping(other->getX(), other->getY()) && other->isEdible())
+		{
+			edible = other;
+			return true;
+		}
+		return false;
+	});
+	return edible;
 }
 
 bool StudentWorld::isBacteriumMovementBlockedAt(Actor* a, double x, double y) const
 {
+	COUNT_EVENT(COUNTER_BLOCKED_QUERIES);
 	// check if (x, y) coordinates are out of range of petri dish
-	if (x > (VIEW_WIDTH / 2 + 128) || x < (VIEW_WIDTH / 2 - 128))
+	double r = m_dishRadius;
+	if (x > 2 * r || x < 0)
+		return true;
+#ifdef KONTAGION_FIXED_POINT
+	// outside the circle exactly when further than r from the center
+	Fixed center = m_dishRadius * FIXED_ONE;
+	int64_t limit = (int64_t)m_dishRadius * FIXED_ONE;
+	if (fixedDistanceSquared(fixedFromDouble(x), fixedFromDouble(y), center, center) > limit * limit)
 		return true;
-	if (y < VIEW_RADIUS - sqrt(pow(VIEW_RADIUS, 2) - pow(x - VIEW_RADIUS, 2)) || y > VIEW_RADIUS + sqrt(pow(VIEW_RADIUS, 2) - pow(x - VIEW_RADIUS, 2)))
+#else
+	if (y < r - sqrt(pow(r, 2) - pow(x - r, 2)) || y > r + sqrt(pow(r, 2) - pow(x - r, 2)))
 		return true;
+#endif
 	// for each actor, check if it's a Dirt pile, and if it is, is the passed-in actor a close enough to be considered "blocked" by the Dirt pile?
-	for (auto it = m_actors.begin(); it != m_actors.end(); it++)
+	return m_grid.forEachNear(x, y, SPRITE_RADIUS, [&](Actor* other)
 	{
-		if ((*it)->blocksBacteriumMovement() && sqrt(pow(x - (*it)->getX(), 2) + pow(y - (*it)->getY(), 2)) <= SPRITE_RADIUS)
-			return true;
-	}
-	return false;
+		COUNT_EVENT(COUNTER_ACTOR_COMPARISONS);
+		return !other->isDead() && other->blocksBacteriumMovement() && other->getDistance(x, y) <= SPRITE_RADIUS;
+	});
 }
 
 bool StudentWorld::getAngleToNearbySocrates(Actor* a, int dist, int& angle) const
 {
+	// use this tick's batch if it has the answer
+	int i = batchIndexOf(a);
+	if (i >= 0)
+	{
+		if (m_socratesQueries.distance(i) > dist)
+			return false;
+		angle = m_socratesQueries.angle(i);
+		return true;
+	}
 	// if actor a is not within dist units away from Socrates, return false
 	if (a->getDistance(m_player->getX(), m_player->getY()) > dist)
 		return false;
 	// otherwise, set angle to the angle between actor a and Socrates in degrees, and return true
-	angle = atan2((m_player->getY() - a->getY()), (m_player->getX() - a->getX())) * 180 / PI;
+	angle = angleBetween(a->getX(), a->getY(), m_player->getX(), m_player->getY());
 	return true;
 }
 
 bool StudentWorld::getAngleToNearestNearbyEdible(Actor* a, int dist, int& angle) const
 {
-	// check each actor. if it is a food item and it's within dist units of actor a, set angle to angle between them and return true
-	for (auto it = m_actors.begin(); it != m_actors.end(); it++)
+	// only food in the cells of the food grid within dist of actor a can be close enough. if several
+	// food items are, go for the one that comes first among all the actors, as bacteria always have
+	Actor* food = nullptr;
+	int foodPosition = -1;
+	m_foodGrid.forEachNear(a->getX(), a->getY(), dist, [&](Actor* other)
 	{
-		if ((*it)->isEdible() && (*it)->getDistance(a->getX(), a->getY()) <= dist)
+		COUNT_EVENT(COUNTER_ACTOR_COMPARISONS);
+		if (!other->isDead() && other->getDistance(a->getX(), a->getY()) <= dist)
 		{
-			angle = atan2((*it)->getY() - a->getY(), (*it)->getX() - a->getX()) * 180 / PI;
-			return true;
+			int position = m_actors.positionOf(other->handle());
+			if (food == nullptr || position < foodPosition)
+			{
+				food = other;
+				foodPosition = position;
+			}
 		}
-	}
-	// otherwise, no food item close enough to Actor a was found, so return false
-	return false;
+		return false;
+	});
+	// no food item close enough to Actor a was found, so return false
+	if (food == nullptr)
+		return false;
+	// otherwise, set angle to angle between them and return true
+	angle = angleBetween(a->getX(), a->getY(), food->getX(), food->getY());
+	return true;
+}
+
+int StudentWorld::dishRadius() const
+{
+	return m_dishRadius;
+}
+
+bool StudentWorld::isSocratesInvulnerable() const
+{
+	return m_socratesInvulnerable;
+}
+
+double StudentWorld::dishAreaScale() const
+{
+	return (double)m_dishRadius * m_dishRadius / (VIEW_RADIUS * VIEW_RADIUS);
 }
 
 void StudentWorld::getPositionOnCircumference(int angle, double& x, double& y) const
 {
+#ifdef KONTAGION_FIXED_POINT
+	x = m_dishRadius + fixedToDouble(m_dishRadius * fixedCos(angle));
+	y = m_dishRadius + fixedToDouble(m_dishRadius * fixedSin(angle));
+#else
 	// x equals radius times cosine theta
-	x = VIEW_WIDTH / 2 + VIEW_RADIUS * cos(angle * PI / 180);
+	x = m_dishRadius + m_dishRadius * cos(angle * PI / 180);
 	// y equals radius times sin theta
-	y = VIEW_HEIGHT / 2 + VIEW_RADIUS * sin(angle * PI / 180);
+	y = m_dishRadius + m_dishRadius * sin(angle * PI / 180);
+#endif
 }
 
-bool StudentWorld::damageOneActor(Actor* a, int damage)
-{
-	for (auto it = m_actors.begin(); it != m_actors.end(); it++)
+int StudentWorld::angleBetween(double fromX, double fromY, double toX, double toY) const
+{
+#ifdef KONTAGION_FIXED_POINT
+	return fixedAngleDegrees(fixedFromDouble(toY) - fixedFromDouble(fromY), fixedFromDouble(toX) - fixedFromDouble(fromX));
+#else
+	return atan2(toY - fromY, toX - fromX) * 180 / PI;
+#endif
+}
+
+bool StudentWorld::damageOneActor(double x0, double y0, double x1, double y1, int damage, EventCause cause)
+{
+	// find every live actor that the path from (x0, y0) to (x1, y1) comes close enough to,
+	// and how far along the path it gets close enough; only cells along the path need to be checked
+	COUNT_EVENT(COUNTER_DAMAGE_QUERIES);
+	vector<pair<double, Actor*>> touched;
+	m_grid.forEachAlongSegment(x0, y0, x1, y1, SPRITE_WIDTH, [&](Actor* other)
+	{
+		COUNT_EVENT(COUNTER_ACTOR_COMPARISONS);
+		double t;
+		if (!other->isDead() && SpatialGrid::firstContactAlongSegment(other->getX(), other->getY(), SPRITE_WIDTH, x0, y0, x1, y1, t))
+			touched.push_back(make_pair(t, other));
+		return false;
+	});
+	stable_sort(touched.begin(), touched.end(), [](const pair<double, Actor*>& p1, const pair<double, Actor*>& p2)
+	{
+		return p1.first < p2.first;
+	});
+	// try to damage them in the order the path reaches them; actors that can't take damage (e.g. dirt) don't stop the path
+	for (auto it = touched.begin(); it != touched.end(); it++)
 	{
-		// if actor is close enough and actor is bacterium, set bacterium to dead and increase game score by 100
-		if ((*it)->getDistance(a->getX(), a->getY()) <= SPRITE_WIDTH && (*it)->takeDamage(damage))
+		Actor* target = it->second;
+		// if actor is bacterium, damage it and increase game score by 100
+		if (target->takeDamage(damage, cause))
 		{
 			increaseScore(100);
-			if ((*it)->isDead())
+			if (target->isDead())
 			{
 				// there's a 50% chance that the bacterium killed becomes food
 				int rand = randInt(0, 1);
 				if (rand == 0)
-					addActor(new Food(this, (*it)->getX(), (*it)->getY()));
+					addActor(new Food(target->getX(), target->getY()), CAUSE_REMAINS);
 			}
 			return true;
 		}
 	}
 	return false;
-}
\ No newline at end of file
+}
@@ -2,11 +2,21 @@
 #define STUDENTWORLD_INCLUDED
 
 #include "GameWorld.h"
+#include "Actor.h"
+#include "SpatialGrid.h"
+#include "ParticleSystem.h"
+#include "ActorSlotMap.h"
+#include "TimerWheel.h"
+#include "AIScheduler.h"
+#include "SocratesQueryBatch.h"
+#include "JobSystem.h"
+#include "JobGraph.h"
+#include "WorldFeed.h"
+#include "EventLog.h"
+#include "EngineCounters.h"
 #include <string>
-#include <list>
-
-class Actor;
-class Socrates;
+#include <vector>
+#include <utility>
 
 class StudentWorld : public GameWorld
 {
@@ -23,12 +33,54 @@ public:
 	// delete all dynamically allocated objects to ensure no memory leak
 	virtual void cleanUp();
 
-	// Add an actor to the world.
-	void addActor(Actor* a);
+	// "-feed filename" publishes the world's state every tick to a memory
+	// mapped file that other programs can watch (see WorldFeed.h),
+	// "-events filename" logs gameplay events to a file (see EventLog.h),
+	// "-aiBudget us" limits how long bacteria spend planning each tick
+	// (see setAIBudget).  "-footprint 1" and "-tickJobs 1" print
+	// footprintReport() and tickGraphReport() when the world is destroyed.
+	// For stress testing, "-dishRadius r" sets the Petri dish's radius,
+	// "-pits n" puts n pits in every level, "-pitQuota r,a,e" fills each
+	// pit with r regular salmonella, a aggressive salmonella and e E. coli,
+	// "-foodDensity d" puts d food items in every 10000 square pixels, and
+	// "-invulnerable 1" keeps Socrates from ever being hurt, so a stress
+	// test isn't cut short by his running out of lives.  "-spatialSort n"
+	// checks the actors' spatial order every n ticks instead of every
+	// SPATIAL_SORT_INTERVAL, or never with 0, to see what the sorting buys.
+	// "-dispatch virtual" has actors act through the vtable instead of
+	// Actor::update's switch on their type, to time one against the other.
+	virtual bool setOption(std::string name, std::string value);
+
+	// Add an actor to the world; cause is why it appeared, for the event log.
+	void addActor(Actor* a, EventCause cause = CAUSE_NONE);
+
+	// Return the actor the handle refers to, or nullptr if that actor has
+	// died and been removed from the world.
+	Actor* getActor(ActorHandle h) const;
+
+	// Update the spatial index after actor a moved away from (oldX, oldY).
+	void actorMoved(Actor* a, double oldX, double oldY);
+
+	// Remember that actor a just died, so it can be removed at the end of
+	// the tick.
+	void actorDied(Actor* a);
 
-	// If actor a ovelaps some live actor, damage that live actor by the
-	// indicated amount of damage and return true; otherwise, return false.
-	bool damageOneActor(Actor* a, int damage);
+	// Record that something happened to actor a, if events are being
+	// logged.  other is the type of whatever else took part, if anything.
+	void logEvent(EventKind kind, const Actor* a, EventCause cause, int other = EVENT_NO_ACTOR, int amount = 0);
+
+	// Wake actor a up (i.e., have it doSomething) delay ticks from now.
+	// Only bacteria act every tick; everything else sleeps until woken.
+	void scheduleActor(Actor* a, int delay);
+
+	// Fire a spray or a flame from (x, y) in direction dir.
+	void addSpray(double x, double y, int dir);
+	void addFlame(double x, double y, int dir);
+
+	// If the path from (x0, y0) to (x1, y1) overlaps some live actor, damage
+	// the first such actor along the path by the indicated amount of damage
+	// (done by the indicated cause) and return true; otherwise, return false.
+	bool damageOneActor(double x0, double y0, double x1, double y1, int damage, EventCause cause);
 
 	// Is bacterium a blocked from moving to the indicated location?
 	bool isBacteriumMovementBlockedAt(Actor* a, double x, double y) const;
@@ -51,6 +103,47 @@ public:
 	// to the direction from actor a to the edible object nearest to it.
 	bool getAngleToNearestNearbyEdible(Actor* a, int dist, int& angle) const;
 		
+	// Should bacterium a work out a new plan this tick, or keep following
+	// its old one?  (Always true unless there's an AI time budget.)
+	bool mayReplan(Actor* a) const;
+
+	// Limit how long bacteria can spend planning each tick, in microseconds
+	// (0 for no limit), and see how that's going.
+	void setAIBudget(double micros);
+	const AIBudgetStats& aiBudgetStats() const;
+
+	// How many live actors (pits and bacteria) are keeping the level from
+	// being completed?  This is kept up to date as actors are added and
+	// removed, so checking it is cheap.
+	int numLevelBlockers() const;
+
+	// How many actors of the indicated type are in the world?
+	int numActors(ActorType type) const;
+
+	// A table of how many bytes each type of actor takes up, both in the
+	// object itself and in the world's indexes of actors, and how much
+	// memory the most actors of that type alive at once took.  It's printed
+	// when the world is destroyed if -footprint was given.
+	std::string footprintReport() const;
+
+	// How many queries, distance checks, actor comparisons and so on the
+	// last tick took (see EngineCounters.h; all zeros unless the game was
+	// built with KONTAGION_COUNTERS).  A report is printed when the world is
+	// destroyed.
+	const CounterSnapshot& tickCounters() const;
+
+	// A table of the jobs each tick is split into, what each has to wait
+	// for, and how long each has been taking.  It's printed when the world
+	// is destroyed if -tickJobs was given.
+	std::string tickGraphReport() const;
+
+	// The radius of the Petri dish (VIEW_RADIUS unless changed with
+	// -dishRadius).  Its center is at (dishRadius(), dishRadius()).
+	int dishRadius() const;
+
+	// Has Socrates been made immune to damage with -invulnerable?
+	bool isSocratesInvulnerable() const;
+
 	// Set x and y to the position on the circumference of the Petri dish
 	// at the indicated angle from the center.  (The circumference is
 	// where socrates and goodies are placed.)
@@ -58,18 +151,108 @@ public:
 
 private:
 	Socrates* m_player;
-	std::list<Actor*> m_actors;
+	ActorSlotMap m_actors;
+	SpatialGrid m_grid;
+	SpatialGrid m_foodGrid;				// just the edible actors, which bacteria look for from much further away
+	ParticleSystem m_particles;
+	int m_typeCounts[NUM_ACTOR_TYPES];
+	int m_peakTypeCounts[NUM_ACTOR_TYPES];	// the most of each type alive at once
+	std::vector<Actor*> m_ticking;		// the actors that act every tick (bacteria)
+	std::vector<Actor*> m_dying;		// actors that died this tick
+	TimerWheel m_timers;
+	AIScheduler m_ai;
+	std::vector<ActorHandle> m_due;
+	SocratesQueryBatch m_socratesQueries;	// this tick's distances and angles from each bacterium to Socrates
+	int m_currentTicking;				// index in m_ticking of the bacterium that's moving (-1 if none)
+	std::vector<unsigned int> m_mortonKeys;					// scratch space for restoreSpatialOrder
+	std::vector<std::pair<unsigned int, Actor*>> m_mortonOrder;
+	JobSystem m_jobs;
+	JobGraph m_tickGraph;					// everything move does after Socrates moves
+	int m_tickStatus;						// what move will return this tick
+	WorldFeed m_feed;						// only open if asked for with -feed
+	EventLog m_events;						// only open if asked for with -events
+	EngineCounters m_counters;
+	int m_dishRadius;
+	int m_numPits;							// -1 for as many as the level number
+	int m_pitQuota[3];						// regular salmonella, aggressive salmonella and E. coli in each pit
+	double m_foodDensity;					// food per 10000 square pixels, or -1 to go by the level
+	bool m_socratesInvulnerable;
+	bool m_reportFootprint;
+	bool m_reportTickJobs;
+	int m_spatialSortInterval;				// ticks between checks of the actors' spatial order (0 for never)
+	bool m_virtualDispatch;					// call doSomething through the vtable instead of update (-dispatch virtual)
 
 	// Private functions
 
+	// sets up m_tickGraph
+	void buildTickGraph();
+
+	// lets every bacterium make its move
+	void moveBacteria();
+
+	// maybe adds a fungus and/or a goodie
+	void addFungusAndGoodies();
+
+	// updates the status bar
+	void updateStatusText();
+
+	// writes this tick's record to the feed, if there is one
+	void publishFeed();
+
+	// removes dead actor a from the world and deletes it
+	void removeActor(Actor* a);
+
+	// removes and deletes every actor that died during this tick
+	void removeDeadActors();
+
+	// lets Socrates pick up any goodies he's touching
+	void pickUpGoodies();
+
+	// wakes up the actors whose timers are due this tick
+	void runTimers();
+
+	// has actor a do this tick's action, through update or the vtable
+	void act(Actor* a);
+
+	// sorts the bacteria's update order, and the packed array of all actors,
+	// by Morton code if they've drifted too far out of that order
+	void restoreSpatialOrder();
+
+	// returns the index of actor a's answers in m_socratesQueries, or -1
+	// if a isn't the bacterium that's moving or has moved since they were
+	// worked out
+	int batchIndexOf(const Actor* a) const;
+
+	// returns the direction from (fromX, fromY) to (toX, toY) in degrees
+	int angleBetween(double fromX, double fromY, double toX, double toY) const;
+
+	// how many bytes the world's indexes use per actor of the indicated type
+	size_t indexBytesPerActor(ActorType type) const;
+
+	// deletes every actor
+	void deleteAllActors();
+
 	// checks if x and y are valid positions in petri dish (no illegal overlaps)
 	bool isValid(double& x, double& y) const;
 
-	// generates a random position in petri dish
-	void generateRandomPos(double& x, double& y);
+	// generates a random position in petri dish; returns false if no free spot turned up after MAX_PLACEMENT_TRIES tries
+	bool generateRandomPos(double& x, double& y);
+
+	// says so if fewer of something than wanted fit in the dish
+	void reportCrowding(const char* what, int placed, int wanted) const;
+
+	// how much bigger the dish's area is than the standard dish's
+	double dishAreaScale() const;
 
-	// Class constant (private)
+	// Class constants (private)
 	const double PI = 3.141592653589;
+	static const int FOOD_CELL_SIZE = 64;			// food is sparse, so its grid's cells are bigger
+	static const int MAX_DISH_RADIUS = 8192;		// past this, positions overflow the fixed point and event log formats
+	static const int MAX_PLACEMENT_TRIES = 1000;	// random spots tried before the dish is taken to be full
+	const double MAX_FOOD_DENSITY = 10;				// past this, food can get too crowded to place without overlaps
+	static const int SPATIAL_SORT_INTERVAL = 32;	// how many ticks between checks of the actors' spatial order
+	static const int QUERY_GRAIN = 4096;			// fewest bacteria worth handing another thread for the Socrates queries (about 40 us of work)
+	static const int MAX_TICK_WORKERS = 3;			// the queries are the only sizable work that splits, and more pieces than this aren't worth waking threads for
 };
 
 #endif // STUDENTWORLD_INCLUDED
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "TimerWheel.h"
+using namespace std;
+
+/**********************************************************************************/
+/*                      TIMERWHEEL CLASS IMPLEMENTATION                           */
+/**********************************************************************************/
+TimerWheel::TimerWheel(int numBuckets)
+	: m_buckets(numBuckets)
+{
+	m_now = 0;
+	m_nTimers = 0;
+}
+
+void TimerWheel::schedule(ActorHandle h, int delay)
+{
+	if (delay < 1)
+		delay = 1;
+	Timer t;
+	t.handle = h;
+	t.tick = m_now + delay;
+	m_buckets[t.tick % m_buckets.size()].push_back(t);
+	m_nTimers++;
+}
+
+void TimerWheel::advance(vector<ActorHandle>& due)
+{
+	m_now++;
+	vector<Timer>& bucket = m_buckets[m_now % m_buckets.size()];
+	// pull out the timers that are due now; timers for a later trip around the ring stay put
+	size_t i = 0;
+	while (i < bucket.size())
+	{
+		if (bucket[i].tick == m_now)
+		{
+			due.push_back(bucket[i].handle);
+			bucket[i] = bucket.back();
+			bucket.pop_back();
+			m_nTimers--;
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void TimerWheel::clear()
+{
+	for (auto it = m_buckets.begin(); it != m_buckets.end(); it++)
+		it->clear();
+	m_now = 0;
+	m_nTimers = 0;
+}
+
+long TimerWheel::currentTick() const
+{
+	return m_now;
+}
+
+int TimerWheel::size() const
+{
+	return m_nTimers;
+}
@@ -0,0 +1,45 @@
+#ifndef TIMERWHEEL_INCLUDED
+#define TIMERWHEEL_INCLUDED
+
+#include "ActorSlotMap.h"
+#include <vector>
+
+// Wakes actors up at a chosen tick, so actors that only do something now and
+// then (a Goodie expiring, a Pit releasing a bacterium) don't have to be
+// looked at every tick.  Timers are hashed into a ring of buckets by the tick
+// they are due on; a timer further away than one trip around the ring just
+// stays in its bucket until its tick comes up.
+class TimerWheel
+{
+public:
+	TimerWheel(int numBuckets);
+
+	// Arrange for the actor with handle h to be woken up delay ticks from now.
+	// A delay less than 1 is treated as 1 (i.e., the next tick).
+	void schedule(ActorHandle h, int delay);
+
+	// Advance to the next tick and append the handles of the actors due on
+	// it to due.
+	void advance(std::vector<ActorHandle>& due);
+
+	// Cancel every timer and start counting ticks from 0 again.
+	void clear();
+
+	// What tick is it?
+	long currentTick() const;
+
+	// How many timers are waiting?
+	int size() const;
+
+private:
+	struct Timer
+	{
+		ActorHandle handle;
+		long tick;
+	};
+	std::vector<std::vector<Timer>> m_buckets;
+	long m_now;
+	int m_nTimers;
+};
+
+#endif // TIMERWHEEL_INCLUDED
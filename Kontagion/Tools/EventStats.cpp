@@ -0,0 +1,144 @@
+  // Sums up an event log written by running the game with "-events filename"
+  // (see EventLog.h) into a table per level: what was spawned, what died and
+  // of what, where the damage went, and how much eating, dividing and
+  // goodie collecting went on.
+  //
+  // Build it from this directory with
+  //     g++ -std=c++11 -O2 -I.. EventStats.cpp ../EventLog.cpp -o EventStats -lpthread
+  // or
+  //     cl /EHsc /O2 /I.. EventStats.cpp ..\EventLog.cpp
+  // and run it as
+  //     EventStats kontagion.events
+
+#include "EventLog.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct LevelStats
+{
+    long events = 0;
+    long longestTry = 0;            // ticks (the tick count starts over when Socrates dies)
+    long socratesDeaths = 0;
+    bool completed = false;
+    long spawned[EVENT_LOG_MAX_TYPES] = {};
+    long died[EVENT_LOG_MAX_TYPES][NUM_EVENT_CAUSES] = {};
+    long damageBy[NUM_EVENT_CAUSES] = {};
+    long damageToSocrates[NUM_EVENT_CAUSES] = {};
+    long foodEaten = 0;
+    long divisions = 0;
+    long pickups = 0;
+    long pickupPoints = 0;
+};
+
+static string causeList(const long counts[NUM_EVENT_CAUSES])
+{
+    ostringstream oss;
+    for (int c = 0; c < NUM_EVENT_CAUSES; c++)
+    {
+        if (counts[c] == 0)
+            continue;
+        if (oss.tellp() > 0)
+            oss << ", ";
+        oss << EVENT_CAUSE_NAMES[c] << " " << counts[c];
+    }
+    return oss.str();
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        cout << "usage: " << argv[0] << " eventLog" << endl;
+        return 1;
+    }
+    ifstream in(argv[1], ios::in | ios::binary);
+    EventLogHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, "KEVT", 4) != 0
+        || header.version != EVENT_LOG_VERSION || header.eventBytes != sizeof(GameEvent)
+        || header.numTypes > static_cast<uint32_t>(EVENT_LOG_MAX_TYPES))
+    {
+        cout << argv[1] << " isn't an event log this version understands" << endl;
+        return 1;
+    }
+    int socrates = -1;
+    for (uint32_t t = 0; t < header.numTypes; t++)
+    {
+        if (strcmp(header.typeNames[t], "Socrates") == 0)
+            socrates = t;
+    }
+
+    map<int, LevelStats> levels;
+    long total = 0, bad = 0;
+    vector<GameEvent> chunk(4096);
+    while (in)
+    {
+        in.read(reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(GameEvent));
+        size_t n = static_cast<size_t>(in.gcount()) / sizeof(GameEvent);
+        for (size_t i = 0; i < n; i++)
+        {
+            const GameEvent& e = chunk[i];
+            if (e.kind >= NUM_EVENT_KINDS || e.cause >= NUM_EVENT_CAUSES || e.actor >= header.numTypes)
+            {
+                bad++;
+                continue;
+            }
+            total++;
+            LevelStats& s = levels[e.level];
+            s.events++;
+            s.longestTry = max(s.longestTry, static_cast<long>(e.tick));
+            switch (e.kind)
+            {
+                case EVENT_SPAWN:           s.spawned[e.actor]++; break;
+                case EVENT_DEATH:
+                    s.died[e.actor][e.cause]++;
+                    if (e.actor == socrates)
+                        s.socratesDeaths++;
+                    break;
+                case EVENT_DAMAGE:
+                    s.damageBy[e.cause] += e.amount;
+                    if (e.actor == socrates)
+                        s.damageToSocrates[e.cause] += e.amount;
+                    break;
+                case EVENT_FOOD_EATEN:      s.foodEaten++; break;
+                case EVENT_DIVISION:        s.divisions++; break;
+                case EVENT_GOODIE_PICKUP:   s.pickups++; s.pickupPoints += e.amount; break;
+                case EVENT_LEVEL_COMPLETE:  s.completed = true; break;
+            }
+        }
+    }
+
+    cout << total << " events";
+    if (bad > 0)
+        cout << " (and " << bad << " unreadable ones)";
+    cout << endl;
+    for (auto it = levels.begin(); it != levels.end(); it++)
+    {
+        const LevelStats& s = it->second;
+        cout << endl << "Level " << it->first << ": " << (s.completed ? "completed" : "not completed")
+             << ", Socrates died " << s.socratesDeaths << " time" << (s.socratesDeaths == 1 ? "" : "s")
+             << ", longest try " << s.longestTry << " ticks, " << s.events << " events" << endl;
+        cout << "  " << left << setw(24) << "type" << right << setw(9) << "spawned" << setw(8) << "died" << "  causes of death" << endl;
+        for (uint32_t t = 0; t < header.numTypes; t++)
+        {
+            long died = 0;
+            for (int c = 0; c < NUM_EVENT_CAUSES; c++)
+                died += s.died[t][c];
+            if (s.spawned[t] == 0 && died == 0)
+                continue;
+            cout << "  " << left << setw(24) << header.typeNames[t] << right << setw(9) << s.spawned[t] << setw(8) << died
+                 << "  " << causeList(s.died[t]) << endl;
+        }
+        cout << "  damage done: " << causeList(s.damageBy) << endl;
+        cout << "  damage to Socrates: " << causeList(s.damageToSocrates) << endl;
+        cout << "  food eaten " << s.foodEaten << ", divisions " << s.divisions << ", goodies picked up "
+             << s.pickups << " (" << showpos << s.pickupPoints << noshowpos << " points)" << endl;
+    }
+    return 0;
+}
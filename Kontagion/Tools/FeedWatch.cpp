@@ -0,0 +1,96 @@
+  // Follows the live feed a running game publishes with "-feed filename"
+  // (see WorldFeed.h) and prints a line about the world every so often,
+  // as an example of a reader: it maps the file, reads records in place,
+  // and never makes the game wait.  If it falls so far behind that records
+  // are overwritten before it gets to them, it skips ahead and says how
+  // many it missed.
+  //
+  // Build it from this directory with
+  //     g++ -std=c++11 -O2 -I.. FeedWatch.cpp ../WorldFeed.cpp -o FeedWatch
+  // or
+  //     cl /EHsc /O2 /I.. FeedWatch.cpp ..\WorldFeed.cpp
+  // and run it (while or before the game runs with -feed /dev/shm/kontagion.feed) as
+  //     FeedWatch /dev/shm/kontagion.feed [ticksBetweenLines]
+
+#include "WorldFeed.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+using namespace std;
+
+  // One line about a record, or "" if it changed while being read.
+static string describe(const WorldFeedReader& feed, uint64_t n)
+{
+    const FeedRecord* r = feed.view(n);
+    if (r == nullptr)
+        return "";
+    ostringstream oss;
+    oss << "#" << r->sequence << "  level " << r->level << " tick " << r->tick << "  score " << r->score
+        << "  lives " << r->lives << "  health " << r->socratesHealth
+        << "  at (" << r->socratesX / r->positionScale << ", " << r->socratesY / r->positionScale << ") |";
+    const FeedHeader& h = feed.header();
+    for (uint32_t t = 0; t < h.numTypes && t < static_cast<uint32_t>(FEED_MAX_TYPES); t++)
+    {
+        if (r->typeCounts[t] > 0)
+            oss << "  " << h.typeNames[t] << " " << r->typeCounts[t];
+    }
+    oss << "  | " << r->numActors << " actors";
+    return feed.intact(n) ? oss.str() : "";
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2 && argc != 3)
+    {
+        cout << "usage: " << argv[0] << " feedFile [ticksBetweenLines]" << endl;
+        return 1;
+    }
+    string filename = argv[1];
+    uint64_t every = (argc == 3 ? max(atoi(argv[2]), 1) : 30);
+
+    WorldFeedReader feed;
+    while (!feed.open(filename))
+        this_thread::sleep_for(chrono::milliseconds(100));
+
+    uint64_t pos = feed.next();     // start with whatever comes next
+    uint64_t missed = 0;
+    for (;;)
+    {
+        uint64_t next = feed.next();
+        if (next < pos)
+        {
+            cout << "(the game restarted)" << endl;
+            pos = 0;
+        }
+        else if (next - pos > static_cast<uint64_t>(FEED_SLOTS))
+        {
+              // lapped: the records in between are gone
+            missed += next - FEED_SLOTS - pos;
+            pos = next - FEED_SLOTS;
+        }
+        if (pos == next)
+        {
+            this_thread::sleep_for(chrono::milliseconds(5));
+            continue;
+        }
+        for (; pos < next; pos++)
+        {
+            if (pos % every != 0)
+                continue;
+            string line = describe(feed, pos);
+            if (line.empty())
+                missed++;
+            else
+                cout << line << endl;
+        }
+        if (missed > 0)
+        {
+            cout << "(fell behind; missed " << missed << " records)" << endl;
+            missed = 0;
+        }
+    }
+}
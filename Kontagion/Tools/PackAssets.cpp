@@ -0,0 +1,191 @@
+  // Bundles every sprite (.tga) and sound (.wav) in an Assets directory into
+  // the single kontagion.pak the game memory maps at startup (see
+  // AssetPack.h for the layout).  Sprites are stored already decoded to
+  // BGRA, scaled to a power of two size, with their whole mipmap chain, so
+  // the game can hand them to OpenGL without doing anything to them.
+  //
+  // Build it from this directory with
+  //     g++ -std=c++11 -O2 -I.. PackAssets.cpp ../SpriteImage.cpp -o PackAssets
+  // or
+  //     cl /EHsc /O2 /I.. PackAssets.cpp ..\SpriteImage.cpp
+  // and run it as
+  //     PackAssets ../Assets
+  // to write ../Assets/kontagion.pak.  Run it again whenever an asset changes.
+  // With -triangle (before the directory), mipmaps are made with the smoother
+  // tent filter rather than gluBuild2DMipmaps' box filter.
+
+#include "AssetPack.h"
+#include "SpriteImage.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifdef _MSC_VER
+#include <windows.h>
+static vector<string> listDirectory(string dir)
+{
+    vector<string> names;
+    WIN32_FIND_DATAA found;
+    HANDLE h = FindFirstFileA((dir + "/*").c_str(), &found);
+    if (h == INVALID_HANDLE_VALUE)
+        return names;
+    do
+    {
+        if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            names.push_back(found.cFileName);
+    } while (FindNextFileA(h, &found));
+    FindClose(h);
+    return names;
+}
+#else
+#include <dirent.h>
+static vector<string> listDirectory(string dir)
+{
+    vector<string> names;
+    DIR* d = opendir(dir.c_str());
+    if (d == nullptr)
+        return names;
+    while (dirent* e = readdir(d))
+    {
+        if (e->d_name[0] != '.')
+            names.push_back(e->d_name);
+    }
+    closedir(d);
+    return names;
+}
+#endif
+
+static bool endsWith(const string& s, const string& suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+  // One file's worth of pack data, before it's placed.
+struct Item
+{
+    string name;
+    uint32_t type;
+    SpriteImage sprite;
+    vector<char> bytes;
+};
+
+static void pad(vector<char>& out)
+{
+    while (out.size() % PACK_ALIGNMENT != 0)
+        out.push_back(0);
+}
+
+int main(int argc, char* argv[])
+{
+    MipFilter filter = MIP_BOX;
+    if (argc == 3 && strcmp(argv[1], "-triangle") == 0)
+        filter = MIP_TRIANGLE;
+    else if (argc != 2)
+    {
+        cout << "usage: " << argv[0] << " [-triangle] assetDirectory" << endl;
+        return 1;
+    }
+    string dir = argv[argc - 1];
+    vector<string> names = listDirectory(dir);
+    sort(names.begin(), names.end());
+
+    vector<Item> items;
+    double decodeSeconds = 0;
+    double megapixels = 0;      // of the sprites at their power-of-two sizes, not counting mipmaps
+    for (const string& name : names)
+    {
+        if (name.size() >= PACK_NAME_LENGTH)
+        {
+            cout << "Skipping " << name << ": name too long" << endl;
+            continue;
+        }
+        Item item;
+        item.name = name;
+        if (endsWith(name, ".tga"))
+        {
+            item.type = PACK_SPRITE;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            if (!loadSpriteImage(dir + "/" + name, true, true, item.sprite, filter))
+            {
+                cout << "Cannot decode " << name << endl;
+                return 1;
+            }
+            decodeSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            megapixels += static_cast<double>(item.sprite.levels[0].width) * item.sprite.levels[0].height / 1e6;
+        }
+        else if (endsWith(name, ".wav"))
+        {
+            item.type = PACK_FILE;
+            ifstream in(dir + "/" + name, ios::in | ios::binary);
+            item.bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+            if (!in && !in.eof())
+            {
+                cout << "Cannot read " << name << endl;
+                return 1;
+            }
+        }
+        else
+            continue;
+        items.push_back(std::move(item));
+    }
+
+      // header and index first, then each item's data
+    PackHeader header;
+    memcpy(header.magic, "KPAK", 4);
+    header.version = PACK_VERSION;
+    header.count = static_cast<uint32_t>(items.size());
+    header.reserved = 0;
+    vector<PackEntry> entries(items.size());
+    vector<char> out(sizeof(header) + entries.size() * sizeof(PackEntry));
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const Item& item = items[i];
+        PackEntry& e = entries[i];
+        memset(&e, 0, sizeof(e));
+        strcpy(e.name, item.name.c_str());
+        e.type = item.type;
+        pad(out);
+        e.offset = out.size();
+        if (item.type == PACK_SPRITE)
+        {
+            const vector<MipLevel>& levels = item.sprite.levels;
+            e.levels = static_cast<uint32_t>(levels.size());
+              // the level table, then the texels (each level aligned)
+            size_t table = out.size();
+            out.resize(out.size() + levels.size() * sizeof(PackMipLevel));
+            for (size_t k = 0; k < levels.size(); k++)
+            {
+                pad(out);
+                PackMipLevel level = { static_cast<uint32_t>(levels[k].width), static_cast<uint32_t>(levels[k].height), out.size() };
+                memcpy(&out[table + k * sizeof(PackMipLevel)], &level, sizeof(level));
+                out.insert(out.end(), levels[k].texels.begin(), levels[k].texels.end());
+            }
+        }
+        else
+            out.insert(out.end(), item.bytes.begin(), item.bytes.end());
+        e.size = out.size() - e.offset;
+    }
+    memcpy(&out[0], &header, sizeof(header));
+    if (!entries.empty())
+        memcpy(&out[sizeof(header)], entries.data(), entries.size() * sizeof(PackEntry));
+
+    string packName = dir + "/" + ASSET_PACK_NAME;
+    ofstream pack(packName, ios::out | ios::binary);
+    pack.write(out.data(), out.size());
+    if (!pack)
+    {
+        cout << "Cannot write " << packName << endl;
+        return 1;
+    }
+    cout << "Wrote " << items.size() << " assets (" << out.size() / 1024 << " KB) to " << packName << endl;
+    if (decodeSeconds > 0)
+        cout << "Decoded " << megapixels << " megapixels of sprites in " << decodeSeconds * 1000 << " ms ("
+             << megapixels / decodeSeconds << " MP/s, including rescaling and mipmaps)" << endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+  // Runs the simulation flat out with nothing drawn and no one at the
+  // keyboard, and reports how the time per tick grows with the number of
+  // bacteria.  It takes the same world options as the game, so a stress
+  // configuration (see the README) can be timed directly:
+  //
+  //     StressBench 2400 300 -dishRadius 4096 -pits 6000 -pitQuota 10,6,4
+  //
+  // runs 2400 ticks and prints a line every 300.  Socrates never runs out
+  // of lives (when he dies, the level starts over, as in the game), so a
+  // long run keeps going; the summary's time per bacterium per tick stays
+  // comparable across such restarts.  Running the same configuration twice,
+  // once with "-dispatch virtual" added, times the actors' type switch
+  // against plain virtual calls on the same mix of actors.
+  //
+  // Build it from this directory with
+  //     g++ -std=c++17 -O2 -I.. StressBench.cpp $(ls ../*.cpp | grep -v main.cpp) -o StressBench -lglut -lGLU -lGL -lpthread
+  // adding -DKONTAGION_HEAP_ACTORS (or any of the game's other build
+  // options) to compare builds.
+
+#include "StudentWorld.h"
+#include "GameController.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+using namespace std;
+
+GameWorld* createStudentWorld(string assetPath);
+
+static int numBacteria(const StudentWorld* world)
+{
+    return world->numActors(ACTOR_ECOLI) + world->numActors(ACTOR_REGULAR_SALMONELLA)
+         + world->numActors(ACTOR_AGGRESSIVE_SALMONELLA);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc % 2 == 0)
+    {
+        cout << "usage: " << argv[0] << " ticks ticksBetweenLines [-name value ...]" << endl;
+        return 1;
+    }
+    int ticks = atoi(argv[1]);
+    int every = max(atoi(argv[2]), 1);
+
+    StudentWorld* world = static_cast<StudentWorld*>(createStudentWorld("Assets/"));
+    world->setController(&Game());
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        if (argv[i][0] != '-' || !world->setOption(argv[i] + 1, argv[i + 1]))
+            cout << "Ignoring unknown option " << argv[i] << endl;
+    }
+
+    using Clock = chrono::steady_clock;
+    auto setUpStart = Clock::now();
+    world->init();
+    cout << "Level set up in " << chrono::duration<double, milli>(Clock::now() - setUpStart).count() << " ms" << endl;
+    cout << setw(8) << "tick" << setw(10) << "actors" << setw(10) << "bacteria" << setw(12) << "ms/tick" << setw(16) << "us/bacterium" << endl;
+
+    double totalMs = 0;             // in ticks only, not setting levels up again
+    double bacteriumTicks = 0;
+    double intervalMs = 0;
+    double intervalBacteriumTicks = 0;
+    int restarts = 0;
+    for (int t = 1; t <= ticks; t++)
+    {
+        int bacteria = numBacteria(world);
+        auto start = Clock::now();
+        int status = world->move();
+        double ms = chrono::duration<double, milli>(Clock::now() - start).count();
+        totalMs += ms;
+        intervalMs += ms;
+        bacteriumTicks += bacteria;
+        intervalBacteriumTicks += bacteria;
+        if (status != GWSTATUS_CONTINUE_GAME)
+        {
+            if (status == GWSTATUS_FINISHED_LEVEL)
+                world->advanceToNextLevel();
+            else
+                world->incLives();
+            world->cleanUp();
+            world->init();
+            restarts++;
+        }
+        if (t % every == 0)
+        {
+            cout << setw(8) << t << setw(10) << world->numActors(ACTOR_DIRT) + world->numActors(ACTOR_FOOD) + world->numActors(ACTOR_PIT) + numBacteria(world)
+                 << setw(10) << numBacteria(world) << setw(12) << fixed << setprecision(3) << intervalMs / every
+                 << setw(16) << setprecision(3) << (intervalBacteriumTicks > 0 ? 1000 * intervalMs / intervalBacteriumTicks : 0.0) << endl;
+            intervalMs = 0;
+            intervalBacteriumTicks = 0;
+        }
+    }
+    cout << ticks << " ticks (" << restarts << " level restarts) in " << fixed << setprecision(1) << totalMs << " ms: "
+         << setprecision(3) << totalMs / ticks << " ms per tick, "
+         << (bacteriumTicks > 0 ? 1000 * totalMs / bacteriumTicks : 0.0) << " us per bacterium per tick" << endl;
+
+    world->cleanUp();
+    delete world;
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include "WorldFeed.h"
+#include <cstring>
+#include <new>
+using namespace std;
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**********************************************************************************/
+/*                       FEEDMAPPING CLASS IMPLEMENTATION                         */
+/**********************************************************************************/
+static size_t slotsOffset()
+{
+	return (sizeof(FeedHeader) + FEED_ALIGNMENT - 1) / FEED_ALIGNMENT * FEED_ALIGNMENT;
+}
+
+FeedMapping::FeedMapping()
+	: m_data(nullptr), m_size(0)
+#ifdef _MSC_VER
+	  , m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#endif
+{
+}
+
+FeedMapping::~FeedMapping()
+{
+	unmap();
+}
+
+size_t FeedMapping::fileSize()
+{
+	return slotsOffset() + FEED_SLOTS * sizeof(FeedSlot);
+}
+
+bool FeedMapping::map(const string& filename, size_t size, bool writable)
+{
+	unmap();
+#ifdef _MSC_VER
+	// everyone shares the file, so readers can come and go while the game writes
+	HANDLE file = CreateFileA(filename.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+							  nullptr, writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER actual;
+	HANDLE mapping = nullptr;
+	if (writable || (GetFileSizeEx(file, &actual) && static_cast<size_t>(actual.QuadPart) >= size))
+	{
+		ULARGE_INTEGER want;
+		want.QuadPart = size;
+		mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, want.HighPart, want.LowPart, nullptr);
+	}
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	m_file = file;
+	m_mapping = mapping;
+	m_data = static_cast<uint8_t*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+#else
+	int fd = ::open(filename.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+	if (fd < 0)
+		return false;
+	struct stat statbuf;
+	bool ok = writable ? ftruncate(fd, size) == 0 : fstat(fd, &statbuf) == 0 && static_cast<size_t>(statbuf.st_size) >= size;
+	void* data = MAP_FAILED;
+	if (ok)
+		data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);	// the mapping keeps the file open
+	if (data != MAP_FAILED)
+		m_data = static_cast<uint8_t*>(data);
+#endif
+	m_size = size;
+	if (m_data == nullptr)
+	{
+		unmap();
+		return false;
+	}
+	return true;
+}
+
+void FeedMapping::unmap()
+{
+#ifdef _MSC_VER
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_data != nullptr)
+		munmap(m_data, m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool FeedMapping::isMapped() const
+{
+	return m_data != nullptr;
+}
+
+FeedHeader* FeedMapping::header() const
+{
+	return reinterpret_cast<FeedHeader*>(m_data);
+}
+
+FeedSlot* FeedMapping::slot(uint64_t sequence) const
+{
+	return reinterpret_cast<FeedSlot*>(m_data + slotsOffset()) + (sequence & (FEED_SLOTS - 1));
+}
+
+/**********************************************************************************/
+/*                        WORLDFEED CLASS IMPLEMENTATION                          */
+/**********************************************************************************/
+bool WorldFeed::open(const string& filename, const char* const typeNames[], int numTypes)
+{
+	if (numTypes > FEED_MAX_TYPES || !m_map.map(filename, FeedMapping::fileSize(), true))
+		return false;
+	// start over, even if the file holds an old game's feed; the magic
+	// number goes in last, so readers never take a half-made header
+	FeedHeader* h = m_map.header();
+	memset(h->magic, 0, sizeof(h->magic));
+	h->version = FEED_VERSION;
+	h->slots = FEED_SLOTS;
+	h->maxActors = FEED_MAX_ACTORS;
+	h->slotBytes = sizeof(FeedSlot);
+	h->numTypes = numTypes;
+	memset(h->typeNames, 0, sizeof(h->typeNames));
+	for (int i = 0; i < numTypes; i++)
+		strncpy(h->typeNames[i], typeNames[i], FEED_TYPE_NAME_LENGTH - 1);
+	new (&h->next) atomic<uint64_t>(0);
+	for (int i = 0; i < FEED_SLOTS; i++)
+		new (&m_map.slot(i)->state) atomic<uint64_t>(0);
+	atomic_thread_fence(memory_order_release);
+	memcpy(h->magic, "KFED", 4);
+	m_next = 0;
+	return true;
+}
+
+void WorldFeed::close()
+{
+	m_map.unmap();
+}
+
+bool WorldFeed::isOpen() const
+{
+	return m_map.isMapped();
+}
+
+FeedRecord& WorldFeed::beginRecord()
+{
+	FeedSlot* s = m_map.slot(m_next);
+	// mark the slot as changing before touching the record, so a reader
+	// that sees any of the new record also sees the odd state afterwards
+	s->state.store(2 * m_next + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	s->record.sequence = m_next;
+	return s->record;
+}
+
+void WorldFeed::publish()
+{
+	m_map.slot(m_next)->state.store(2 * m_next + 2, memory_order_release);
+	m_next++;
+	m_map.header()->next.store(m_next, memory_order_release);
+}
+
+uint64_t WorldFeed::published() const
+{
+	return m_next;
+}
+
+/**********************************************************************************/
+/*                     WORLDFEEDREADER CLASS IMPLEMENTATION                       */
+/**********************************************************************************/
+bool WorldFeedReader::open(const string& filename)
+{
+	if (!m_map.map(filename, FeedMapping::fileSize(), false))
+		return false;
+	const FeedHeader* h = m_map.header();
+	if (memcmp(h->magic, "KFED", 4) != 0 || h->version != FEED_VERSION || h->slots != FEED_SLOTS
+		|| h->maxActors != FEED_MAX_ACTORS || h->slotBytes != sizeof(FeedSlot))
+	{
+		m_map.unmap();
+		return false;
+	}
+	atomic_thread_fence(memory_order_acquire);
+	return true;
+}
+
+void WorldFeedReader::close()
+{
+	m_map.unmap();
+}
+
+const FeedHeader& WorldFeedReader::header() const
+{
+	return *m_map.header();
+}
+
+uint64_t WorldFeedReader::next() const
+{
+	return m_map.header()->next.load(memory_order_acquire);
+}
+
+const FeedRecord* WorldFeedReader::view(uint64_t n) const
+{
+	const FeedSlot* s = m_map.slot(n);
+	if (s->state.load(memory_order_acquire) != 2 * n + 2)
+		return nullptr;
+	return &s->record;
+}
+
+bool WorldFeedReader::intact(uint64_t n) const
+{
+	// everything read from the record has to be read before the state is checked again
+	atomic_thread_fence(memory_order_acquire);
+	return m_map.slot(n)->state.load(memory_order_relaxed) == 2 * n + 2;
+}
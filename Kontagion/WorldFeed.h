@@ -0,0 +1,164 @@
+#ifndef WORLDFEED_INCLUDED
+#define WORLDFEED_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A live feed of the world's state, one record per tick, in a memory mapped
+// file that other programs (dashboards, loggers) can map and read while the
+// game runs.  The file is laid out as
+//
+//     FeedHeader
+//     FeedSlot[FEED_SLOTS], starting on a FEED_ALIGNMENT boundary
+//
+// and record n goes in slot n % FEED_SLOTS, so the newest FEED_SLOTS records
+// are always there.  There's one writer (the game) and any number of
+// readers, and the writer never waits for them: each slot has a sequence
+// word that's odd while the slot is being written, so a reader that was
+// lapped by the writer can tell that what it read is no good.
+
+const std::uint32_t FEED_VERSION = 2;
+const int FEED_SLOTS = 64;				// must be a power of two
+const int FEED_MAX_ACTORS = 4096;		// positions past this many aren't sent
+const int FEED_MAX_TYPES = 16;
+const int FEED_TYPE_NAME_LENGTH = 24;
+const int FEED_POSITION_SCALE = 16;		// positions are in 1/16ths of a pixel, in a dish small enough for that
+const std::size_t FEED_ALIGNMENT = 64;
+
+struct FeedActor
+{
+	std::int16_t x;			// times the record's positionScale
+	std::int16_t y;
+	std::uint16_t type;		// an ActorType
+};
+
+struct FeedRecord
+{
+	std::uint64_t sequence;		// 0 for the first record the game published, 1 for the next, ...
+	std::int32_t level;
+	std::int32_t tick;			// ticks since the level started
+	std::int32_t score;
+	std::int32_t lives;
+	std::int32_t socratesHealth;
+	std::int32_t socratesSprays;
+	std::int32_t socratesFlames;
+	std::int16_t socratesX;		// times positionScale
+	std::int16_t socratesY;
+	std::int32_t positionScale;	// FEED_POSITION_SCALE, or a smaller power of two if the dish is too big for that to fit
+	std::int32_t typeCounts[FEED_MAX_TYPES];	// how many of each ActorType are alive
+	std::int32_t numActors;						// how many actors there are, not counting Socrates
+	std::int32_t numPositions;					// how many of them are in positions (at most FEED_MAX_ACTORS)
+	FeedActor positions[FEED_MAX_ACTORS];
+};
+
+struct FeedHeader
+{
+	char magic[4];						// "KFED"
+	std::uint32_t version;
+	std::uint32_t slots;
+	std::uint32_t maxActors;
+	std::uint32_t slotBytes;			// sizeof(FeedSlot), so readers can check they agree
+	std::uint32_t numTypes;
+	char typeNames[FEED_MAX_TYPES][FEED_TYPE_NAME_LENGTH];	// what each ActorType is called
+	std::atomic<std::uint64_t> next;	// sequence number of the next record to be published
+};
+
+struct alignas(FEED_ALIGNMENT) FeedSlot
+{
+	// 2n + 1 while record n is being written, 2n + 2 once it's done (0 if never written)
+	std::atomic<std::uint64_t> state;
+	FeedRecord record;
+};
+
+// readers in other processes see these words through their own mappings,
+// which only works if they're plain memory rather than hidden locks
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the feed needs lock-free 64-bit atomics");
+
+// The two ends of a feed both map the file the same way.
+class FeedMapping
+{
+public:
+	FeedMapping();
+	~FeedMapping();
+
+	// Map the file, creating it (or resizing it) to size bytes if writable.
+	bool map(const std::string& filename, std::size_t size, bool writable);
+	void unmap();
+	bool isMapped() const;
+
+	FeedHeader* header() const;
+	FeedSlot* slot(std::uint64_t sequence) const;
+
+	// how big a feed file is
+	static std::size_t fileSize();
+
+private:
+	std::uint8_t* m_data;
+	std::size_t m_size;
+#ifdef _MSC_VER
+	void* m_file;
+	void* m_mapping;
+#endif
+
+	FeedMapping(const FeedMapping&);
+	FeedMapping& operator=(const FeedMapping&);
+};
+
+// The game's end of the feed.  Records are filled in right where readers
+// will see them, so publishing one copies nothing.
+class WorldFeed
+{
+public:
+	// Create (or take over) the feed file; typeNames[i] is what ActorType i
+	// is called.  Return false if the file can't be mapped.
+	bool open(const std::string& filename, const char* const typeNames[], int numTypes);
+	void close();
+	bool isOpen() const;
+
+	// The record to fill in for this tick.  Readers are told it's being
+	// rewritten, so they'll skip it until publish is called.
+	FeedRecord& beginRecord();
+
+	// Make the record beginRecord returned visible to readers.
+	void publish();
+
+	// How many records have been published?
+	std::uint64_t published() const;
+
+private:
+	FeedMapping m_map;
+	std::uint64_t m_next;
+};
+
+// A reader's end of the feed.  Records are read in place: get a pointer
+// with view, read what's wanted, and then check intact, since the writer
+// may have started reusing the slot in the meantime.
+class WorldFeedReader
+{
+public:
+	// Map an existing feed file; false if it isn't there or isn't a feed
+	// this version understands.
+	bool open(const std::string& filename);
+	void close();
+
+	const FeedHeader& header() const;
+
+	// Sequence number of the next record the game will publish.  If that's
+	// ever smaller than it was, the game was restarted.
+	std::uint64_t next() const;
+
+	// Record n, or nullptr if it hasn't been published yet or its slot has
+	// already been reused.
+	const FeedRecord* view(std::uint64_t n) const;
+
+	// Is the record view(n) returned still record n?  If not, it changed
+	// while it was being read, and nothing read from it should be trusted.
+	bool intact(std::uint64_t n) const;
+
+private:
+	FeedMapping m_map;
+};
+
+#endif // WORLDFEED_INCLUDED
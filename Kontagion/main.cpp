@@ -1,4 +1,5 @@
 #include "GameController.h"
+#include "AssetPack.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -42,6 +43,8 @@ int main(int argc, char* argv[])
         }
         assetPath += '/';
     }
+      // With an asset pack, the loose files needn't be there.
+    if (!AssetPack().open(assetPath + ASSET_PACK_NAME))
     {
         const string someAsset = "socrates.tga";
         ifstream ifs(assetPath + someAsset);